@@ -22,109 +22,183 @@
  */
 
 // ======================================================================== //
+// madvise(MADV_HUGEPAGE) and posix_memalign() are declared only with it,
+// also in a strict -std=c11 build
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
 #include "radsort.h"
+#include "radsort_perf.h"
+#include <string.h>
+#include <errno.h>
+#if defined(__linux__) || defined(ASYNC_SORT_ENABLED)
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
 // ======================================================================== //
-// Description of all functions
+// Allocation of large sort buffers and sort statistics
 // ======================================================================== //
 // ------------------------------------------------------------------------ //
-// Make array of buckets with positions/indices of number list with top level
+// Statistics of the last sort which was called from the current thread
+static _Thread_local radsort_stats_t sort_stats;
+
+void radsort_get_stats( radsort_stats_t *stats )
+{
+    if (stats != NULL)  *stats = sort_stats;
+}
+
+static void reset_sort_stats( void )
+{
+    memset(&sort_stats, 0, sizeof(radsort_stats_t));
+}
+// ------------------------------------------------------------------------ //
+
+#ifdef ASYNC_SORT_ENABLED
 // ------------------------------------------------------------------------ //
-static spfifo_t* radix_pos( const uint64_t num_list [], 
-        const uint32_t *pos_list, uint32_t nl_sz, const uint8_t digit_h )
+// Number of threads of a parallel sort step, the number of online CPUs
+// limited to 1 to NUMBER_OF_BUCKETS
+static uint8_t worker_count( void )
 {
-    // Declare fifo struct type array with size of 16 for 16 buckets
-    // Use calloc() to avoid garbage value
-    spfifo_t *indices_list = calloc( NUMBER_OF_BUCKETS, sizeof(spfifo_t));
-    // Call C-macro function to check the success of dynamic memory allocation
-    check_mem_alloc(indices_list);
+    long n_cpu = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n_cpu < 1) ? 1 :
+        (n_cpu > NUMBER_OF_BUCKETS) ? NUMBER_OF_BUCKETS : (uint8_t)n_cpu;
+}
+// ------------------------------------------------------------------------ //
+#endif
 
-    // Allocate memory for fifo array(.fdata) of each bucket
-    for(uint8_t b = 0; b < NUMBER_OF_BUCKETS; ++b) {
-        indices_list[b].fdata = (uint32_t *)malloc( sizeof(uint32_t) * nl_sz);
-        check_mem_alloc_partial(indices_list, b);
-    }
+#ifdef PREFAULT_ENABLED
+// ------------------------------------------------------------------------ //
+// Touch one byte of each 4K page, so the page fault is taken before sorting
+static void* prefault_pages( void *pf_args )
+{
+    const prefault_args_t *pargs = (const prefault_args_t *)pf_args;
+    for (size_t off = 0; off < pargs->len; off += 4096)
+        pargs->start[off] = 0;
+    return NULL;
+}
+// ------------------------------------------------------------------------ //
 
-    // Calculate right shift amount of a number to get a specific hex digit
-    uint8_t shift_base = (digit_h - 1) << 2;  // (digit_h-1)*4 bits
-    
-    // Get each item of current bucket and distribute indices into new buckets
-    for( uint32_t i = 0; i < nl_sz; ++i) {
-        // If top list then take all position one by one (i) otherwise,
-        // take a position from pos_list (index_from_pos_list=ifpl)
-        uint32_t ifpl = (pos_list == NULL) ? i : pos_list[i];
-        // Determine the bucket number by right shift the number by 
-        // (digit-1)*4 bits, then get first digit only
-        uint8_t bucket_num = (num_list[ifpl] >> shift_base) & 0x0F;
-
-        // Keep the index into the array of a new bucket
-        indices_list[bucket_num].fdata[indices_list[bucket_num].wp] = ifpl;
-        indices_list[bucket_num].wp += 1;
+// ------------------------------------------------------------------------ //
+static void prefault_buffer( void *buf, size_t bytes )
+{
+    #ifdef ASYNC_SORT_ENABLED
+    // Split the buffer by huge page boundary among the worker threads
+    uint8_t n_th = worker_count();
+    size_t n_hp = bytes / HUGE_PAGE_SIZE;
+    size_t hp_per_th = (n_hp + n_th - 1) / n_th;
+    pthread_t threads[NUMBER_OF_BUCKETS];
+    prefault_args_t pf_args[NUMBER_OF_BUCKETS];
+    uint8_t started[NUMBER_OF_BUCKETS] = {0};
+    for (uint8_t t = 0; t < n_th; ++t) {
+        size_t begin = t * hp_per_th * HUGE_PAGE_SIZE;
+        size_t end = begin + hp_per_th * HUGE_PAGE_SIZE;
+        if (begin >= bytes) break;
+        if (end > bytes) end = bytes;
+        pf_args[t].start = (uint8_t *)buf + begin;
+        pf_args[t].len = end - begin;
+        if (t + 1 < n_th && pthread_create(
+                &threads[t], NULL, prefault_pages, &pf_args[t]) == 0) {
+            started[t] = 1;
+        } else {
+            prefault_pages(&pf_args[t]);  // Last part or failed to start
+        }
+    }
+    for (uint8_t t = 0; t < n_th; ++t)
+        if (started[t])  pthread_join(threads[t], NULL);
+    #else
+    prefault_args_t pf_args = { (uint8_t *)buf, bytes };
+    prefault_pages(&pf_args);
+    #endif
+    sort_stats.prefault_bytes += bytes;
+}
+// ------------------------------------------------------------------------ //
+#endif  // PREFAULT_ENABLED
 
-        #ifdef DEBUG_L2
-        // For show the current loop data and status changes
-        printf("[%d]:\tDigit:%d, Cur Pos:%u,\tValue:%8lu(0x%x),\t",
-            i, digit_h, ifpl, num_list[ifpl], num_list[ifpl]);
-        printf("Bucket No.: %x, FIFO pt:%4d, Indices inCurBucket: ",
-            bucket_num, indices_list[bucket_num].wp);
-        for (uint8_t t = 0; t < indices_list[bucket_num].wp; ++t)
-            printf("%2u ", indices_list[bucket_num].fdata[t]);
-        puts("");  // A new line for each loop
+// ------------------------------------------------------------------------ //
+// Allocate a sort buffer, large buffer is aligned and advised to use 2MB
+// transparent huge pages. The buffer can be freed by free().
+static void* sort_buf_alloc( size_t bytes, uint8_t prefault )
+{
+    (void)prefault;
+    #if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (bytes >= HUGE_PAGE_THRESHOLD) {
+        size_t hp_bytes = (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        void *buf = NULL;
+        if (posix_memalign(&buf, HUGE_PAGE_SIZE, hp_bytes) != 0)  return NULL;
+        if (madvise(buf, hp_bytes, MADV_HUGEPAGE) == 0)
+            sort_stats.hp_buffers += 1;
+        #ifdef PREFAULT_ENABLED
+        if (prefault)  prefault_buffer(buf, hp_bytes);
         #endif
+        return buf;
     }
-    // De-allocate some buckets' memory when wp=0
-    for (uint8_t b = 0; b < NUMBER_OF_BUCKETS; b++) {
-        if (indices_list[b].wp == 0) {
-            free(indices_list[b].fdata);
-            indices_list[b].fdata = NULL; //printf("Dealloc bucket %d\n", b);
-        }
-    }
-    // TODO: Check if possible to de-allocate some memory of fdata by wp
-    return indices_list;
+    #endif
+    return malloc(bytes);
 }
 // ------------------------------------------------------------------------ //
 
 // ------------------------------------------------------------------------ //
-static void recur_bucket_merge(const uint64_t u_list[], 
-        const spfifo_t *cur_buckets, const uint8_t cur_digit_h, 
-        spfifo_t *soi_f )
+// Add the bytes of large buffers which are backed by huge pages into the
+// statistics, which is read from AnonHugePages of /proc/self/smaps. All
+// buffers of a sort are checked by a single parse of the file, and nothing
+// is done unless HUGE_PAGE_STATS_ENABLED is defined.
+static void note_huge_pages( const void *const bufs[], const size_t bytes[],
+        uint8_t n_bufs )
 {
-    if (cur_buckets == NULL) return;
-    if (cur_digit_h == 0 || cur_digit_h > 15) return;
-    for (uint8_t bl = 0; bl < NUMBER_OF_BUCKETS; ++bl) {
-        if (cur_buckets[bl].wp == 0) continue; // skip it for empty bucket
-        if (cur_buckets[bl].wp == 1) {
-            // For single item bucket, just keep the index, skip the rest
-            soi_f->fdata[(soi_f->wp)++] = cur_buckets[bl].fdata[0];
-            #ifdef DEBUG_L2
-            printf("  Number of merged indices(ios): %u\n", soi_f->wp);
-            #endif
-            continue;  // Skip to next bucket
-        }
-        spfifo_t *newL_buckets = radix_pos(
-            u_list, cur_buckets[bl].fdata, cur_buckets[bl].wp, cur_digit_h
-        );
-        if (newL_buckets == NULL) continue;  // if failed allocating memory
-        if (cur_digit_h == 1) {
-            // For last level of buckets, keep all indices in seq. of indices
-            for (uint8_t m = 0; m < NUMBER_OF_BUCKETS; ++m) {
-                for (uint32_t n = 0; n < newL_buckets[m].wp; ++n) {
-                    soi_f->fdata[(soi_f->wp)++] = newL_buckets[m].fdata[n];
-                    #ifdef DEBUG_L2
-                    printf("\t->Number of merged indices(ios): %u\n",
-                        soi_f->wp);
-                    #endif
-                }
+    #if defined(__linux__) && defined(HUGE_PAGE_STATS_ENABLED)
+    uint8_t n_large = 0;
+    for (uint8_t b = 0; b < n_bufs; ++b)
+        if (bufs[b] != NULL && bytes[b] >= HUGE_PAGE_THRESHOLD)  n_large += 1;
+    if (n_large == 0)  return;
+    FILE *fp = fopen("/proc/self/smaps", "r");
+    if (fp == NULL)  return;
+    char line[512];
+    uint8_t in_vma = 0;
+    size_t hp_kb = 0, total_kb = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        unsigned long start, end;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+            // A mapping is counted once, even if it holds several buffers
+            in_vma = 0;
+            for (uint8_t b = 0; b < n_bufs; ++b) {
+                uintptr_t addr = (uintptr_t)bufs[b];
+                if (bufs[b] != NULL && bytes[b] >= HUGE_PAGE_THRESHOLD &&
+                    addr >= start && addr < end)  in_vma = 1;
             }
-        } else {  // cur_digit_h > 1
-            recur_bucket_merge(u_list, newL_buckets, (cur_digit_h-1), soi_f);
+        } else if (in_vma &&
+                   sscanf(line, "AnonHugePages: %zu kB", &hp_kb) == 1) {
+            total_kb += hp_kb;
+            in_vma = 0;
         }
-        free_buckets(newL_buckets, NUMBER_OF_BUCKETS);
     }
+    fclose(fp);
+    if (total_kb > 0) {
+        sort_stats.huge_pages = 1;
+        sort_stats.huge_page_bytes += total_kb << 10;
+    }
+    #else
+    (void)bufs;  (void)bytes;  (void)n_bufs;
+    #endif
 }
 // ------------------------------------------------------------------------ //
 
 
+// ======================================================================== //
+// Description of all functions
+// ======================================================================== //
+// ------------------------------------------------------------------------ //
+// Bucket functions and recur_radix_sort_hNd() of 64-bit numbers, the bucket
+// functions are used by all uint64_t sort functions
+#define RADSORT_KEY_T      uint64_t
+#define RADSORT_SFX
+#define RADSORT_MAX_DIGIT  16
+#include "radsort_bucket.inc"
+// ------------------------------------------------------------------------ //
+
+
 // ======================================================================== //
 // Sort unsorted list of integer number using radix sort algorithm
 // ------------------------------------------------------------------------ //
@@ -134,7 +208,9 @@ uint64_t* radix_sort_h4d( const uint64_t u_list [], uint32_t l_size,
 {
     // Declare an array for merging indices and index of that array 
     // (ios=index of 'sequence_of_indices')
-    uint32_t *sequence_of_indices = malloc( sizeof(uint32_t) * l_size);
+    reset_sort_stats();
+    uint32_t *sequence_of_indices = sort_buf_alloc(
+        sizeof(uint32_t) * l_size, 1);
     check_mem_alloc(sequence_of_indices);
     uint32_t ios = 0;
     
@@ -172,7 +248,7 @@ uint64_t* radix_sort_h4d( const uint64_t u_list [], uint32_t l_size,
 
                 // Merge the indices into a fifo sequentially
                 for(uint8_t m = 0; m < 16; ++m) {
-                    for(uint8_t n = 0; n < bucket_l1[m].wp; ++n) {
+                    for(uint32_t n = 0; n < bucket_l1[m].wp; ++n) {
                         // Take the index from the bucket and keep into the fifo
                         sequence_of_indices[ios] = bucket_l1[m].fdata[n];  ios += 1;
                         // printf("Number of merged indices(ios): %u\n", ios);
@@ -193,7 +269,7 @@ uint64_t* radix_sort_h4d( const uint64_t u_list [], uint32_t l_size,
     #endif
 
     // Dynamically allocate memory for sorted list which must be same size and length as unsorted list
-    uint64_t *s_list = malloc(sizeof(uint64_t) * l_size);
+    uint64_t *s_list = sort_buf_alloc(sizeof(uint64_t) * l_size, 1);
     check_mem_alloc2(s_list, sequence_of_indices);
     
     // Copy the unsorted array into sorted_array according to the sequence of 'sequence_of_indice' fifo
@@ -206,99 +282,770 @@ uint64_t* radix_sort_h4d( const uint64_t u_list [], uint32_t l_size,
         // Iterate through the fifo in forward order
         for(uint32_t i = 0; i < ios; ++i)  s_list[i] = u_list[sequence_of_indices[i]];
     }
+    const void *hp_bufs[2] = { sequence_of_indices, s_list };
+    const size_t hp_bytes[2] = { sizeof(uint32_t) * l_size,
+                                 sizeof(uint64_t) * l_size };
+    note_huge_pages(hp_bufs, hp_bytes, 2);
     free(sequence_of_indices);  sequence_of_indices = NULL;  //puts("");
     return s_list;
 }
 // ------------------------------------------------------------------------ //
 
+
+// ======================================================================== //
+// Narrow key width specializations (8/16/32-bit keys)
 // ------------------------------------------------------------------------ //
-// Maximum digit = N (<=16)
-uint64_t* recur_radix_sort_hNd( const uint64_t u_list [], uint32_t l_size, 
-        uint8_t digit_h_N, char sort_order )
+/**
+ * Counting sort for keys whose sorted digits fit in a table of 16^digit_h_N
+ * counters (8-bit and 16-bit keys). When all digits of the key type are used
+ * the keys are re-generated from the counters, so the input is read exactly
+ * once. Otherwise the keys are scattered by the counters' prefix sum to keep
+ * the bits above digit_h_N untouched, same as the bucket version does.
+ */
+#define RADSORT_DEFINE_COUNT_SORT(fn_name, key_t, max_digit)                 \
+key_t* fn_name( const key_t u_list [], uint32_t l_size,                      \
+        uint8_t digit_h_N, char sort_order )                                 \
+{                                                                            \
+    if(digit_h_N == 0 || digit_h_N > max_digit) {                            \
+        printf("Maximum hexadcimal digit can be %d. Current digit is %d.\n", \
+            max_digit, digit_h_N);                                           \
+        return NULL;                                                         \
+    }                                                                        \
+    reset_sort_stats();                                                      \
+    uint32_t n_cnt = 1u << (digit_h_N << 2);  /* 16^digit_h_N counters */    \
+    uint32_t mask = n_cnt - 1;                                               \
+    uint32_t *cnt = calloc(n_cnt, sizeof(uint32_t));                         \
+    check_mem_alloc(cnt);                                                    \
+    key_t *s_list = sort_buf_alloc(sizeof(key_t) * l_size, 1);               \
+    check_mem_alloc2(s_list, cnt);                                           \
+    /* The single counting pass over the unsorted list */                    \
+    for(uint32_t i = 0; i < l_size; ++i)  cnt[u_list[i] & mask] += 1;        \
+    if(sort_order != 'a' && sort_order != 'd')                               \
+        printf("Wrong sort order input '%c'. Default ascending order used.\n",\
+            sort_order);                                                     \
+    if(digit_h_N == max_digit) {                                             \
+        /* Whole key is counted, so write the values back from counters */   \
+        uint32_t s_cnt = 0;                                                  \
+        for(uint32_t k = 0; k < n_cnt; ++k) {                                \
+            uint32_t v = (sort_order == 'd') ? (mask - k) : k;               \
+            for(uint32_t c = 0; c < cnt[v]; ++c)  s_list[s_cnt++] = v;       \
+        }                                                                    \
+    } else {                                                                 \
+        /* Exclusive prefix sum of counters according to sort order */       \
+        uint32_t sum = 0;                                                    \
+        for(uint32_t k = 0; k < n_cnt; ++k) {                                \
+            uint32_t v = (sort_order == 'd') ? (mask - k) : k;               \
+            uint32_t c = cnt[v];  cnt[v] = sum;  sum += c;                   \
+        }                                                                    \
+        for(uint32_t i = 0; i < l_size; ++i)                                 \
+            s_list[cnt[u_list[i] & mask]++] = u_list[i];                     \
+    }                                                                        \
+    free(cnt);  cnt = NULL;                                                  \
+    const void *hp_bufs[1] = { s_list };                                     \
+    const size_t hp_bytes[1] = { sizeof(key_t) * l_size };                   \
+    note_huge_pages(hp_bufs, hp_bytes, 1);                                   \
+    return s_list;                                                           \
+}
+
+// 8-bit and 16-bit keys are sorted by a single counting pass
+RADSORT_DEFINE_COUNT_SORT(recur_radix_sort_hNd_u8, uint8_t, 2)
+RADSORT_DEFINE_COUNT_SORT(recur_radix_sort_hNd_u16, uint16_t, 4)
+// 32-bit keys use the same bucket radix sort in their native width
+#define RADSORT_KEY_T      uint32_t
+#define RADSORT_SFX        _u32
+#define RADSORT_MAX_DIGIT  8
+#include "radsort_bucket.inc"
+// ------------------------------------------------------------------------ //
+
+
+// ======================================================================== //
+// Selection of ranks (top-k, partial sort and nth element) by bucket pruning
+// ------------------------------------------------------------------------ //
+// Keep all indices of a bucket into the fifo, used for unneeded buckets
+static void keep_bucket_indices( const spfifo_t *bucket, uint32_t from,
+        spfifo_t *fifo )
+{
+    if (fifo == NULL) return;
+    for (uint32_t n = from; n < bucket->wp; ++n)
+        fifo->fdata[(fifo->wp)++] = bucket->fdata[n];
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// Sort all indices of a single bucket into the sequence of indices
+static void sort_bucket_indices( const uint64_t u_list[],
+        const spfifo_t *bucket, const uint8_t cur_digit_h, char s_order,
+        spfifo_t *soi_f )
+{
+    uint32_t seg_start = soi_f->wp;
+    if (bucket->wp == 1 || cur_digit_h == 0 ||
+        is_same_key_bucket(u_list, bucket)) {
+        // Single item, same numbers or last level bucket, keep the indices
+        keep_bucket_indices(bucket, 0, soi_f);
+        return;
+    }
+    spfifo_t *newL_buckets = radix_pos(
+        u_list, bucket->fdata, bucket->wp, cur_digit_h
+    );
+    if (newL_buckets == NULL) return;  // if failed allocating memory
+    if (cur_digit_h == 1) {
+        for (uint8_t m = 0; m < NUMBER_OF_BUCKETS; ++m)
+            keep_bucket_indices(&newL_buckets[m], 0, soi_f);
+    } else {
+        recur_bucket_merge(u_list, newL_buckets, (cur_digit_h-1), soi_f);
+    }
+    free_buckets(newL_buckets, NUMBER_OF_BUCKETS);
+    if (s_order == 'd') {
+        // Reverse the sorted indices of this bucket for descending order
+        for (uint32_t i = seg_start, j = soi_f->wp - 1; i < j; ++i, --j) {
+            uint32_t tmp = soi_f->fdata[i];
+            soi_f->fdata[i] = soi_f->fdata[j];
+            soi_f->fdata[j] = tmp;
+        }
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+static void recur_bucket_select( const uint64_t u_list[],
+        const spfifo_t *cur_buckets, const uint8_t cur_digit_h,
+        uint32_t k, char s_order, spfifo_t *soi_f, spfifo_t *rest_f )
+{
+    if (cur_buckets == NULL) return;
+    for (uint8_t i = 0; i < NUMBER_OF_BUCKETS; ++i) {
+        // Visit the buckets according to sort order
+        uint8_t bl = (s_order == 'd') ? (NUMBER_OF_BUCKETS - 1 - i) : i;
+        if (cur_buckets[bl].wp == 0) continue;  // skip it for empty bucket
+        if (soi_f->wp >= k) {
+            // All ranks are found, rest of the buckets are not needed
+            if (rest_f == NULL) return;
+            keep_bucket_indices(&cur_buckets[bl], 0, rest_f);
+            continue;
+        }
+        if (soi_f->wp + cur_buckets[bl].wp <= k) {
+            // Whole bucket is in the target ranks, sort it fully
+            sort_bucket_indices(
+                u_list, &cur_buckets[bl], cur_digit_h, s_order, soi_f
+            );
+            continue;
+        }
+        // The bucket hold the last target rank, so only split this bucket
+        if (cur_digit_h == 0 ||
+            is_same_key_bucket(u_list, &cur_buckets[bl])) {
+            // Last level, all items have same value, take only needed items
+            uint32_t need = k - soi_f->wp;
+            for (uint32_t n = 0; n < need; ++n)
+                soi_f->fdata[(soi_f->wp)++] = cur_buckets[bl].fdata[n];
+            keep_bucket_indices(&cur_buckets[bl], need, rest_f);
+            continue;
+        }
+        spfifo_t *newL_buckets = radix_pos(
+            u_list, cur_buckets[bl].fdata, cur_buckets[bl].wp, cur_digit_h
+        );
+        if (newL_buckets == NULL) continue;  // if failed allocating memory
+        recur_bucket_select(u_list, newL_buckets, (cur_digit_h-1), k,
+            s_order, soi_f, rest_f);
+        free_buckets(newL_buckets, NUMBER_OF_BUCKETS);
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// Make the sequence of indices of first k ranks (and rest of the indices if
+// rest_f is not NULL) in sort order
+static uint32_t* radix_select_indices( const uint64_t u_list [],
+        uint32_t l_size, uint8_t digit_h_N, uint32_t k, char sort_order,
+        uint8_t keep_rest )
 {
     if(digit_h_N == 0 || digit_h_N > 16) {
-        puts("Maximum hexadcimal digit can be 16. Zero digit is invalid.");
-        printf("Current digit is %d.\n", digit_h_N);
+        printf("Maximum hexadcimal digit can be 16. Current digit is %d.\n",
+            digit_h_N);
         return NULL;
     }
-    // Declare a fifo for merging indices into a sequence of indices(soi)
-    spfifo_t soi_fifo;
-    soi_fifo.fdata = (uint32_t *)malloc( sizeof(uint32_t) * l_size);
+    if(k == 0 || k > l_size) {
+        printf("Number of ranks %u is out of list size %u.\n", k, l_size);
+        return NULL;
+    }
+    if(sort_order != 'a' && sort_order != 'd') {
+        printf("Wrong sort order input '%c'. Default ascending order used.\n",
+            sort_order);
+        sort_order = 'a';
+    }
+    reset_sort_stats();
+    // The selected indices followed by the rest use the same array
+    spfifo_t soi_fifo, rest_fifo;
+    soi_fifo.fdata = (uint32_t *)malloc(
+        sizeof(uint32_t) * (keep_rest ? l_size : k));
     check_mem_alloc(soi_fifo.fdata);
     soi_fifo.wp = 0;
+    rest_fifo.fdata = soi_fifo.fdata + k;
+    rest_fifo.wp = 0;
 
-    #ifdef DEBUG
-    puts("------------------ Start of bucket level: blN ------------------");
-    //getchar();
-    #endif
-    // Make top level buckets by the value of number of digit
     spfifo_t *bucket_lN = radix_pos(u_list, NULL, l_size, digit_h_N);
     if (bucket_lN == NULL) {
         free(soi_fifo.fdata);  soi_fifo.fdata = NULL;
         return NULL;
     }
-    #ifdef DEBUG
-    puts("End of top level buckets making.");
-    //getchar();
-    #endif
-    // Start the main loop which check and sort according to radix position
-    recur_bucket_merge( u_list, bucket_lN, (digit_h_N-1), &soi_fifo );
-    free_buckets(bucket_lN, NUMBER_OF_BUCKETS);  // Free the top level bucket
-    #ifdef DEBUG
-    puts("======== End  of bucket level blN =======");
-    for (int i = 0; i < soi_fifo.wp; i++) {
-        printf("soi_fifo[%d]-> %u \n", i, soi_fifo.fdata[i]);
-        if( i > 10 )  break;  // To avoid unnecessary print full list
-    }
-    #endif
-    
-    // Dynamically allocate memory for sorted list which must be same size and
-    // length as unsorted list
+    recur_bucket_select( u_list, bucket_lN, (digit_h_N-1), k, sort_order,
+        &soi_fifo, keep_rest ? &rest_fifo : NULL );
+    free_buckets(bucket_lN, NUMBER_OF_BUCKETS);
+    return soi_fifo.fdata;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+uint64_t* radix_topk( const uint64_t u_list [], uint32_t l_size,
+        uint8_t digit_h_N, uint32_t k, char sort_order )
+{
+    uint32_t *soi = radix_select_indices(
+        u_list, l_size, digit_h_N, k, sort_order, 0);
+    if (soi == NULL) return NULL;
+    uint64_t *s_list = malloc(sizeof(uint64_t) * k);
+    check_mem_alloc2(s_list, soi);
+    for(uint32_t i = 0; i < k; ++i)  s_list[i] = u_list[soi[i]];
+    free(soi);  soi = NULL;
+    return s_list;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+uint64_t* radix_partial_sort( const uint64_t u_list [], uint32_t l_size,
+        uint8_t digit_h_N, uint32_t k, char sort_order )
+{
+    uint32_t *soi = radix_select_indices(
+        u_list, l_size, digit_h_N, k, sort_order, 1);
+    if (soi == NULL) return NULL;
     uint64_t *s_list = malloc(sizeof(uint64_t) * l_size);
-    check_mem_alloc2(s_list, soi_fifo.fdata);
-    
-    // Copy the unsorted array into sorted_array according to the sequence of
-    // 'sequence_of_indice' fifo
+    check_mem_alloc2(s_list, soi);
+    for(uint32_t i = 0; i < l_size; ++i)  s_list[i] = u_list[soi[i]];
+    free(soi);  soi = NULL;
+    return s_list;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+const uint64_t* radix_nth_element( const uint64_t u_list [], uint32_t l_size,
+        uint8_t digit_h_N, uint32_t nth, char sort_order )
+{
+    if(digit_h_N == 0 || digit_h_N > 16) {
+        printf("Maximum hexadcimal digit can be 16. Current digit is %d.\n",
+            digit_h_N);
+        return NULL;
+    }
+    if(nth >= l_size) {
+        printf("Rank %u is out of list size %u.\n", nth, l_size);
+        return NULL;
+    }
+    // Rank in ascending order, since the buckets are in ascending order
+    uint32_t rank = (sort_order == 'd') ? (l_size - 1 - nth) : nth;
+    reset_sort_stats();
+    spfifo_t *cur_buckets = radix_pos(u_list, NULL, l_size, digit_h_N);
+    if (cur_buckets == NULL) return NULL;
+    for (uint8_t digit_h = digit_h_N - 1; ; --digit_h) {
+        // Find the only bucket which hold the rank, and skip the others
+        uint8_t bl = 0;
+        for (; bl < NUMBER_OF_BUCKETS - 1; ++bl) {
+            if (rank < cur_buckets[bl].wp) break;
+            rank -= cur_buckets[bl].wp;
+        }
+        if (cur_buckets[bl].wp == 1 || digit_h == 0 ||
+            is_same_key_bucket(u_list, &cur_buckets[bl])) {
+            // All items of last level bucket have same value
+            const uint64_t *nth_item = &u_list[cur_buckets[bl].fdata[rank]];
+            free_buckets(cur_buckets, NUMBER_OF_BUCKETS);
+            return nth_item;
+        }
+        spfifo_t *newL_buckets = radix_pos(
+            u_list, cur_buckets[bl].fdata, cur_buckets[bl].wp, digit_h
+        );
+        free_buckets(cur_buckets, NUMBER_OF_BUCKETS);
+        if (newL_buckets == NULL) return NULL;
+        cur_buckets = newL_buckets;
+    }
+}
+// ------------------------------------------------------------------------ //
+
+
+// ======================================================================== //
+// Sorted unique numbers with count of occurrence (group-by-count)
+// ------------------------------------------------------------------------ //
+static void recur_bucket_count( const uint64_t u_list[],
+        const spfifo_t *cur_buckets, const uint8_t cur_digit_h,
+        uint64_t *uq_list, uint32_t *cnt_list, uint32_t *n_unique )
+{
+    if (cur_buckets == NULL) return;
+    for (uint8_t bl = 0; bl < NUMBER_OF_BUCKETS; ++bl) {
+        if (cur_buckets[bl].wp == 0) continue; // skip it for empty bucket
+        if (cur_buckets[bl].wp == 1 || cur_digit_h == 0 ||
+            is_same_key_bucket(u_list, &cur_buckets[bl])) {
+            // All numbers of the bucket are same, keep one with the count
+            uq_list[*n_unique] = u_list[cur_buckets[bl].fdata[0]];
+            cnt_list[*n_unique] = cur_buckets[bl].wp;
+            *n_unique += 1;
+            continue;
+        }
+        spfifo_t *newL_buckets = radix_pos(
+            u_list, cur_buckets[bl].fdata, cur_buckets[bl].wp, cur_digit_h
+        );
+        if (newL_buckets == NULL) continue;  // if failed allocating memory
+        recur_bucket_count(u_list, newL_buckets, (cur_digit_h-1),
+            uq_list, cnt_list, n_unique);
+        free_buckets(newL_buckets, NUMBER_OF_BUCKETS);
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+uint64_t* radix_sort_unique_count( const uint64_t u_list [], uint32_t l_size,
+        uint8_t digit_h_N, char sort_order, uint32_t **counts,
+        uint32_t *n_unique )
+{
+    if(digit_h_N == 0 || digit_h_N > 16) {
+        printf("Maximum hexadcimal digit can be 16. Current digit is %d.\n",
+            digit_h_N);
+        return NULL;
+    }
+    if(counts == NULL || n_unique == NULL) {
+        printf("No place to return counts of unique numbers.\n");
+        return NULL;
+    }
+    reset_sort_stats();
+    // Allocate for the worst case (all unique), then shrink at the end. An
+    // empty list has empty result, one item is allocated to avoid malloc(0).
+    uint64_t *uq_list = malloc(sizeof(uint64_t) * (l_size ? l_size : 1));
+    check_mem_alloc(uq_list);
+    uint32_t *cnt_list = malloc(sizeof(uint32_t) * (l_size ? l_size : 1));
+    check_mem_alloc2(cnt_list, uq_list);
+    uint32_t n_uq = 0;
+    if (l_size == 0) {
+        *counts = cnt_list;
+        *n_unique = 0;
+        return uq_list;
+    }
+
+    spfifo_t *bucket_lN = radix_pos(u_list, NULL, l_size, digit_h_N);
+    if (bucket_lN == NULL) {
+        free(cnt_list);  cnt_list = NULL;
+        free(uq_list);  uq_list = NULL;
+        return NULL;
+    }
+    recur_bucket_count(u_list, bucket_lN, (digit_h_N-1),
+        uq_list, cnt_list, &n_uq);
+    free_buckets(bucket_lN, NUMBER_OF_BUCKETS);
+
     if(sort_order == 'd') {
-        soi_fifo.wp -= 1;
-        // Iterate through the fifo in reverse order
-        for(int32_t i = soi_fifo.wp; i >= 0; --i)
-            s_list[(soi_fifo.wp-i)] = u_list[soi_fifo.fdata[i]];
-    } else {
-        if(sort_order != 'a')
-            printf("Wrong sort order input '%c'. Default ascending order used.\n",
-                sort_order);
-        // Iterate through the fifo in forward order
-        for(uint32_t i = 0; i < soi_fifo.wp; ++i)
-            s_list[i] = u_list[soi_fifo.fdata[i]];
+        // Reverse both lists for descending order, nothing for 0 or 1 item
+        for(uint32_t i = 0, j = (n_uq > 0) ? n_uq - 1 : 0; i < j; ++i, --j) {
+            uint64_t tmp_num = uq_list[i];
+            uq_list[i] = uq_list[j];  uq_list[j] = tmp_num;
+            uint32_t tmp_cnt = cnt_list[i];
+            cnt_list[i] = cnt_list[j];  cnt_list[j] = tmp_cnt;
+        }
+    } else if(sort_order != 'a') {
+        printf("Wrong sort order input '%c'. Default ascending order used.\n",
+            sort_order);
+    }
+    // Shrink the lists to the number of unique numbers
+    if (n_uq > 0 && n_uq < l_size) {
+        uint64_t *uq_shrink = realloc(uq_list, sizeof(uint64_t) * n_uq);
+        if (uq_shrink != NULL)  uq_list = uq_shrink;
+        uint32_t *cnt_shrink = realloc(cnt_list, sizeof(uint32_t) * n_uq);
+        if (cnt_shrink != NULL)  cnt_list = cnt_shrink;
+    }
+    *counts = cnt_list;
+    *n_unique = n_uq;
+    return uq_list;
+}
+// ------------------------------------------------------------------------ //
+
+
+// ======================================================================== //
+// Segmented sort of many small lists in one call
+// ------------------------------------------------------------------------ //
+// Sort one segment which is already copied into dst, tmp is the scratch
+// buffer with at least seg_sz items
+static void sort_one_segment( uint64_t *dst, uint64_t *tmp, uint32_t seg_sz,
+        uint8_t digit_h_N, char s_order )
+{
+    if (seg_sz <= SMALL_BUCKET_SIZE) {
+        // Small segment, insertion sort in sort order
+        for (uint32_t i = 1; i < seg_sz; ++i) {
+            uint64_t key = dst[i];
+            uint32_t j = i;
+            for (; j > 0 && ((s_order == 'd') ? (dst[j-1] < key) :
+                                                (dst[j-1] > key)); --j)
+                dst[j] = dst[j-1];
+            dst[j] = key;
+        }
+        return;
+    }
+    // Counting pass for each hex digit from 1s digit, the buckets are only
+    // 16 counters and the numbers are moved between dst and tmp buffer
+    uint64_t *src = dst, *out = tmp;
+    for (uint8_t digit_h = 1; digit_h <= digit_h_N; ++digit_h) {
+        uint8_t shift_base = (digit_h - 1) << 2;
+        uint32_t cnt[NUMBER_OF_BUCKETS] = {0};
+        for (uint32_t i = 0; i < seg_sz; ++i)
+            cnt[(src[i] >> shift_base) & 0x0F] += 1;
+        // Skip the digit when all numbers are in the same bucket
+        if (cnt[(src[0] >> shift_base) & 0x0F] == seg_sz) continue;
+        uint32_t sum = 0;
+        for (uint8_t k = 0; k < NUMBER_OF_BUCKETS; ++k) {
+            uint8_t b = (s_order == 'd') ? (NUMBER_OF_BUCKETS - 1 - k) : k;
+            uint32_t c = cnt[b];  cnt[b] = sum;  sum += c;
+        }
+        for (uint32_t i = 0; i < seg_sz; ++i)
+            out[cnt[(src[i] >> shift_base) & 0x0F]++] = src[i];
+        uint64_t *swap = src;  src = out;  out = swap;
+    }
+    if (src != dst)  memcpy(dst, src, sizeof(uint64_t) * seg_sz);
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// Sort a range of segments, used directly or as a thread function
+static void* sort_segment_range( void *s_args )
+{
+    const seg_args_t *sargs = (const seg_args_t *)s_args;
+    for (uint32_t s = sargs->seg_begin; s < sargs->seg_end; ++s) {
+        uint32_t begin = sargs->seg_offs[s];
+        uint32_t seg_sz = sargs->seg_offs[s+1] - begin;
+        if (seg_sz == 0)  continue;
+        uint64_t *dst = sargs->s_list + begin;
+        if (dst != sargs->u_list + begin)
+            memcpy(dst, sargs->u_list + begin, sizeof(uint64_t) * seg_sz);
+        sort_one_segment(dst, sargs->scratch, seg_sz, sargs->digit_h_N,
+            sargs->s_order);
+    }
+    return NULL;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// Allocate the scratch buffer for the largest segment of a range
+static uint64_t* alloc_segment_scratch( const uint32_t seg_offs[],
+        uint32_t seg_begin, uint32_t seg_end )
+{
+    uint32_t max_sz = 1;
+    for (uint32_t s = seg_begin; s < seg_end; ++s) {
+        uint32_t seg_sz = seg_offs[s+1] - seg_offs[s];
+        if (seg_sz > max_sz)  max_sz = seg_sz;
+    }
+    return malloc(sizeof(uint64_t) * max_sz);
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+uint64_t* radix_sort_segments( const uint64_t u_list [],
+        const uint32_t seg_offs [], uint32_t n_segs, uint8_t digit_h_N,
+        char sort_order, uint64_t *s_list )
+{
+    if(digit_h_N == 0 || digit_h_N > 16) {
+        printf("Maximum hexadcimal digit can be 16. Current digit is %d.\n",
+            digit_h_N);
+        return NULL;
     }
-    free(soi_fifo.fdata);  soi_fifo.fdata = NULL;
+    if(seg_offs == NULL || n_segs == 0) {
+        printf("No segment to sort.\n");
+        return NULL;
+    }
+    if(sort_order != 'a' && sort_order != 'd') {
+        printf("Wrong sort order input '%c'. Default ascending order used.\n",
+            sort_order);
+        sort_order = 'a';
+    }
+    uint32_t l_size = seg_offs[n_segs];
+    uint8_t own_s_list = (s_list == NULL);
+    if (own_s_list) {
+        s_list = malloc(sizeof(uint64_t) * (l_size ? l_size : 1));
+        check_mem_alloc(s_list);
+    }
+    seg_args_t sargs = { u_list, seg_offs, 0, n_segs, digit_h_N, sort_order,
+                         s_list, NULL };
+
+    #ifdef ASYNC_SORT_ENABLED
+    // Split the segments into ranges of nearly same number of items, and
+    // sort each range by a thread with its own scratch buffer
+    uint8_t n_th = worker_count();
+    if (l_size >= SEGMENT_PARALLEL_SIZE && n_segs > 1 && n_th > 1) {
+        pthread_t threads[NUMBER_OF_BUCKETS];
+        seg_args_t th_args_list[NUMBER_OF_BUCKETS] = {0};
+        uint8_t started[NUMBER_OF_BUCKETS] = {0};
+        uint8_t failed = 0;
+        uint32_t s = 0;
+        for (uint8_t t = 0; t < n_th; ++t) {
+            // The last item of this range by the prefix of item counts
+            uint64_t range_end = (uint64_t)l_size * (t + 1) / n_th;
+            th_args_list[t] = sargs;
+            th_args_list[t].seg_begin = s;
+            while (s < n_segs && (t == n_th - 1 || seg_offs[s+1] <= range_end))
+                ++s;
+            th_args_list[t].seg_end = s;
+            if (th_args_list[t].seg_begin == s)  continue;  // Empty range
+            th_args_list[t].scratch = alloc_segment_scratch(
+                seg_offs, th_args_list[t].seg_begin, s);
+            if (th_args_list[t].scratch == NULL) {
+                printf("Failed to allocate memory.\n");
+                failed = 1;  break;
+            }
+            int rc = pthread_create(&threads[t], NULL, sort_segment_range,
+                                    (void *)&th_args_list[t]);
+            if (rc) {
+                // Sort the range in this thread, if a thread can't start
+                sort_segment_range(&th_args_list[t]);
+            } else {
+                started[t] = 1;
+            }
+        }
+        for (uint8_t t = 0; t < n_th; ++t) {
+            if (started[t])  pthread_join(threads[t], NULL);
+            free(th_args_list[t].scratch);
+        }
+        if (failed) {
+            if (own_s_list)  free(s_list);
+            return NULL;
+        }
+        return s_list;
+    }
+    #endif
+    // Single thread, one scratch buffer is shared by all segments
+    sargs.scratch = alloc_segment_scratch(seg_offs, 0, n_segs);
+    if (sargs.scratch == NULL) {
+        printf("Failed to allocate memory.\n");
+        if (own_s_list)  free(s_list);
+        return NULL;
+    }
+    sort_segment_range(&sargs);
+    free(sargs.scratch);  sargs.scratch = NULL;
     return s_list;
 }
 // ------------------------------------------------------------------------ //
 
 
+// ======================================================================== //
+// Merge-insert of an unsorted batch into an already sorted list
+// ------------------------------------------------------------------------ //
+// Check if number x goes after number y in sort order
+static inline uint8_t is_after( uint64_t x, uint64_t y, char s_order )
+{
+    return (s_order == 'd') ? (x < y) : (x > y);
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// Find the first index of sorted list[0..n) from where all numbers go after
+// the key. Search from the end by steps of 1, 2, 4, ... then binary search,
+// so a short block near the end is found in few steps.
+static uint32_t gallop_after( const uint64_t list[], uint32_t n, uint64_t key,
+        char s_order )
+{
+    uint32_t lo = 0, hi = n;
+    uint64_t step = 1;
+    while (hi >= step) {
+        uint32_t idx = hi - (uint32_t)step;
+        if (!is_after(list[idx], key, s_order)) {
+            lo = idx + 1;
+            break;
+        }
+        hi = idx;
+        step <<= 1;
+    }
+    while (lo < hi) {
+        uint32_t mid = lo + ((hi - lo) >> 1);
+        if (is_after(list[mid], key, s_order))  hi = mid;
+        else  lo = mid + 1;
+    }
+    return lo;
+}
+// ------------------------------------------------------------------------ //
+
+#ifdef ASYNC_SORT_ENABLED
+// ------------------------------------------------------------------------ //
+// Find the number of items of sorted list[0..n) which top digit (the number
+// shifted by shift bits) goes before the top digit top_d in sort order
+static uint32_t top_digit_bound( const uint64_t list[], uint32_t n,
+        uint64_t top_d, uint8_t shift, char s_order )
+{
+    uint32_t lo = 0, hi = n;
+    while (lo < hi) {
+        uint32_t mid = lo + ((hi - lo) >> 1);
+        if (is_after(top_d, list[mid] >> shift, s_order))  lo = mid + 1;
+        else  hi = mid;
+    }
+    return lo;
+}
+// ------------------------------------------------------------------------ //
+#endif  // ASYNC_SORT_ENABLED
+
+// ------------------------------------------------------------------------ //
+// Merge a part of sorted list and sorted batch into out, used directly or
+// as a thread function. Items of sorted list go before same numbers of batch.
+static void* merge_sorted_part( void *m_args )
+{
+    const merge_args_t *margs = (const merge_args_t *)m_args;
+    const uint64_t *s_list = margs->s_list, *b_list = margs->b_list;
+    uint64_t *out = margs->out;
+    uint32_t i = 0, j = 0, w = 0;
+    while (i < margs->s_size && j < margs->b_size) {
+        if (is_after(s_list[i], b_list[j], margs->s_order))
+            out[w++] = b_list[j++];
+        else
+            out[w++] = s_list[i++];
+    }
+    memcpy(out + w, s_list + i, sizeof(uint64_t) * (margs->s_size - i));
+    w += margs->s_size - i;
+    memcpy(out + w, b_list + j, sizeof(uint64_t) * (margs->b_size - j));
+    return NULL;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+uint64_t* radix_merge_insert( uint64_t s_list [], uint32_t s_size,
+        const uint64_t batch [], uint32_t b_size, uint8_t digit_h_N,
+        char sort_order, uint64_t *out )
+{
+    if(digit_h_N == 0 || digit_h_N > 16) {
+        printf("Maximum hexadcimal digit can be 16. Current digit is %d.\n",
+            digit_h_N);
+        return NULL;
+    }
+    if(s_list == NULL || (batch == NULL && b_size != 0)) {
+        printf("No sorted list or batch to merge.\n");
+        return NULL;
+    }
+    if((uint64_t)s_size + b_size > UINT32_MAX) {
+        printf("Merged list size %llu is too large.\n",
+            (unsigned long long)s_size + b_size);
+        return NULL;
+    }
+    if(sort_order != 'a' && sort_order != 'd') {
+        printf("Wrong sort order input '%c'. Default ascending order used.\n",
+            sort_order);
+        sort_order = 'a';
+    }
+    if (out == s_list)  out = NULL;  // Same list, merge in place
+    if (b_size == 0) {
+        if (out != NULL)  memcpy(out, s_list, sizeof(uint64_t) * s_size);
+        return (out != NULL) ? out : s_list;
+    }
+    // Sort only the batch, it is also the scratch buffer of the merge
+    uint64_t *b_list = recur_radix_sort_hNd(batch, b_size, digit_h_N,
+                                            sort_order);
+    if (b_list == NULL)  return NULL;
+
+    if (out == NULL) {
+        // In place, merge from the end into the free room of s_list. Each
+        // block of s_list which go after a batch number is moved only once.
+        uint32_t i = s_size, w = s_size + b_size;
+        for (uint32_t j = b_size; j > 0; --j) {
+            uint32_t p = gallop_after(s_list, i, b_list[j-1], sort_order);
+            w -= i - p;
+            memmove(&s_list[w], &s_list[p], sizeof(uint64_t) * (i - p));
+            i = p;
+            s_list[--w] = b_list[j-1];
+        }
+        free(b_list);  b_list = NULL;
+        return s_list;
+    }
+    merge_args_t margs = { s_list, s_size, b_list, b_size, sort_order, out };
+
+    #ifdef ASYNC_SORT_ENABLED
+    // Split both lists by the top digit into parts of nearly same number of
+    // items of sorted list, and merge each part by a thread
+    uint8_t n_th = worker_count();
+    if (s_size + b_size >= MERGE_PARALLEL_SIZE && s_size > 0 && n_th > 1) {
+        pthread_t threads[NUMBER_OF_BUCKETS];
+        merge_args_t th_args_list[NUMBER_OF_BUCKETS];
+        uint8_t started[NUMBER_OF_BUCKETS] = {0};
+        uint8_t shift = (digit_h_N - 1) << 2;
+        uint32_t s_begin = 0, b_begin = 0;
+        for (uint8_t t = 0; t < n_th; ++t) {
+            uint32_t s_end = s_size, b_end = b_size;
+            if (t < n_th - 1) {
+                // The top digit of the item at the end of this part
+                uint64_t top_d =
+                    s_list[(uint64_t)s_size * (t + 1) / n_th] >> shift;
+                s_end = top_digit_bound(s_list, s_size, top_d, shift,
+                                        sort_order);
+                b_end = top_digit_bound(b_list, b_size, top_d, shift,
+                                        sort_order);
+            }
+            th_args_list[t] = margs;
+            th_args_list[t].s_list = s_list + s_begin;
+            th_args_list[t].s_size = s_end - s_begin;
+            th_args_list[t].b_list = b_list + b_begin;
+            th_args_list[t].b_size = b_end - b_begin;
+            th_args_list[t].out = out + s_begin + b_begin;
+            s_begin = s_end;  b_begin = b_end;
+            if (th_args_list[t].s_size + th_args_list[t].b_size == 0)
+                continue;  // Empty part
+            int rc = pthread_create(&threads[t], NULL, merge_sorted_part,
+                                    (void *)&th_args_list[t]);
+            if (rc) {
+                // Merge the part in this thread, if a thread can't start
+                merge_sorted_part(&th_args_list[t]);
+            } else {
+                started[t] = 1;
+            }
+        }
+        for (uint8_t t = 0; t < n_th; ++t)
+            if (started[t])  pthread_join(threads[t], NULL);
+        free(b_list);  b_list = NULL;
+        return out;
+    }
+    #endif
+    merge_sorted_part(&margs);
+    free(b_list);  b_list = NULL;
+    return out;
+}
+// ------------------------------------------------------------------------ //
+
+
 // ======================================================================== //
 // ------------------------------------------------------------------------ //
 #ifdef ASYNC_SORT_ENABLED
+// ------------------------------------------------------------------------ //
+static void async_gather_sList( const thread_args_t *const targs )
+{
+    const spfifo_t *sf = targs->soi_f;
+    uint64_t *dst = targs->s_list + targs->s_offset;
+    // Copy the unsorted array into this bucket's part of sorted list 
+    // according to the sequence of 'sequence_of_indice' fifo's index list
+    if ( targs->s_order == 'd' ) {
+        // Iterate through the fifo in reverse order
+        for(uint32_t i = 0; i < sf->wp; ++i)
+            dst[sf->wp - 1 - i] = targs->u_list[sf->fdata[i]];
+    } else {
+        // Iterate through the fifo in forward order
+        for(uint32_t i = 0; i < sf->wp; ++i)
+            dst[i] = targs->u_list[sf->fdata[i]];
+    }
+}
+// ------------------------------------------------------------------------ //
+
 // ------------------------------------------------------------------------ //
 static void async_recur_bucket_merge( thread_args_t *const targs )
 {
     /** This function is needed for async call, due to the issue arise when a 
      * function with multiple parameters called by pthread_create(). A struct
      * is used to pass multiple argument to the single parameter function.
+     * After merging the indices, the thread copy its own bucket into the 
+     * final place of sorted list, so no serial copy is needed after join.
      */
-    if (targs->digit_h_N == 0 ||
-        targs->digit_h_N > 15 || 
+    if (targs->digit_h_N > 15 || 
         targs->bucket == NULL ||
         targs->bucket->wp == 0
     )  return;
-    if (targs->bucket->wp == 1) {
-        // For single item bucket, just keep the index, skip the rest
-        targs->soi_f->fdata[(targs->soi_f->wp)++] = targs->bucket->fdata[0];
+    if (targs->bucket->wp == 1 || targs->digit_h_N == 0 ||
+        is_same_key_bucket(targs->u_list, targs->bucket)) {
+        // For single item, same numbers or last digit bucket, just keep
+        // the indices
+        for (uint32_t n = 0; n < targs->bucket->wp; ++n)
+            targs->soi_f->fdata[(targs->soi_f->wp)++] = targs->bucket->fdata[n];
         #ifdef DEBUG_L2
         printf(" ~Number of merged indices(ios): %u\n", targs->soi_f->wp);
         #endif
+        async_gather_sList(targs);
         return;  // Skip the rest of the function
     }
     spfifo_t *newL_buckets = radix_pos(
@@ -309,38 +1056,7 @@ static void async_recur_bucket_merge( thread_args_t *const targs )
         targs->u_list, newL_buckets, (targs->digit_h_N-1), targs->soi_f
     );
     free_buckets(newL_buckets, NUMBER_OF_BUCKETS);
-}
-// ------------------------------------------------------------------------ //
-
-// ------------------------------------------------------------------------ //
-static void async_merge_sList( const uint64_t u_list [], 
-    const spfifo_t *const sf, char s_order, uint64_t *new_list )
-{
-    uint32_t s_cnt = 0;  // sorting counter for copy data sequentially
-    // Copy the unsorted array into sorted_array according to the sequence of 
-    // 'sequence_of_indice' fifo's index list
-    if ( s_order == 'd' ) {
-        for(int8_t bn = NUMBER_OF_BUCKETS-1; bn >= 0; --bn) {
-            if( sf[bn].fdata == NULL || sf[bn].wp == 0 )  continue;
-            // Iterate through the fifo in reverse order, until first element
-            for(uint32_t i = (sf[bn].wp-1); i > 0; --i) {
-                new_list[s_cnt++] = u_list[sf[bn].fdata[i]];
-            }
-            new_list[s_cnt++] = u_list[sf[bn].fdata[0]]; // copy first element
-        }
-    } else {
-        if(s_order != 'a') {
-            printf("Wrong sort order input '%c'. ", s_order);
-            printf("Default ascending sort order is being used.\n");
-        }
-        for(int8_t bn = 0; bn < NUMBER_OF_BUCKETS; ++bn) {
-            if (sf[bn].fdata == NULL || sf[bn].wp == 0 )  continue;
-            // Iterate through the fifo in forward order
-            for(uint32_t i = 0; i < sf[bn].wp; ++i) {
-                new_list[s_cnt++] = u_list[sf[bn].fdata[i]];
-            }
-        }
-    }
+    async_gather_sList(targs);
 }
 // ------------------------------------------------------------------------ //
 
@@ -355,6 +1071,7 @@ uint64_t* async_radix_sort_hNd( const uint64_t u_list [], uint32_t l_size,
             digit_h_N);
         return NULL;
     }
+    reset_sort_stats();
     // Declare an array of pointers (2D array), for merging indices and index
     // of that array (ios=index of 'sequence_of_indices')
     spfifo_t *soi_fifos = calloc(NUMBER_OF_BUCKETS, sizeof(spfifo_t));
@@ -364,27 +1081,46 @@ uint64_t* async_radix_sort_hNd( const uint64_t u_list [], uint32_t l_size,
     //getchar();
     #endif
     // Make top level bucket by the value of number of digit
+    PERF_BEGIN(PERF_PHASE_TOP);
     spfifo_t *bucket_lN = radix_pos(u_list, NULL, l_size, digit_h_N);
+    PERF_END(PERF_PHASE_TOP);
     if (bucket_lN == NULL) return NULL;
     #ifdef DEBUG
     puts("End of top level buckets making.");
     //getchar();
     #endif
+    // Dynamically allocate memory for sorted list which must be same size 
+    // and length as unsorted list. Each thread copy its bucket into it.
+    uint64_t *s_list = sort_buf_alloc(sizeof(uint64_t) * l_size, 1);
+    if (s_list == NULL) {
+        printf("Memory allocation failed for sorted list.\n");
+        free_2buckets(soi_fifos, bucket_lN);  // Free before return
+        return NULL; // Return NULL on error
+    }
+    if(sort_order != 'a' && sort_order != 'd') {
+        printf("Wrong sort order input '%c'. ", sort_order);
+        printf("Default ascending sort order is being used.\n");
+        sort_order = 'a';
+    }
     // Initialize with Null or Allocate memory for sequence_of_indices 
     // accoding to the bucket_lN[b].wp. Initialize each ios[b] to 0.
     for(uint8_t b = 0; b < NUMBER_OF_BUCKETS; ++b) {
         if( bucket_lN[b].wp == 0 ) {
             soi_fifos[b].fdata = NULL; // Set to NULL if bucket is empty
         } else {
-            soi_fifos[b].fdata = (uint32_t *)malloc(
-                sizeof(uint32_t) * bucket_lN[b].wp);
+            soi_fifos[b].fdata = (uint32_t *)sort_buf_alloc(
+                sizeof(uint32_t) * bucket_lN[b].wp, 1);
+            if (soi_fifos[b].fdata == NULL)  free(s_list);
             check_soi_f_fdata(soi_fifos, b, bucket_lN);
         }
         soi_fifos[b].wp = 0; // Initialize ios to 0 for each bucket
     }
-    // Start the thread pool and assign the tasks to the threads
+    // Start the thread pool and assign the tasks to the threads. Each thread
+    // gather its own bucket, so recursion and gather are measured together.
+    PERF_BEGIN(PERF_PHASE_RECUR);
     pthread_t threads[NUMBER_OF_BUCKETS];
     thread_args_t th_args_list[NUMBER_OF_BUCKETS];
+    uint32_t s_offset = 0;  // Prefix sum of bucket sizes, output position
     for(uint8_t b = 0; b < NUMBER_OF_BUCKETS; ++b) {
         if( bucket_lN[b].wp == 0 ) continue; // Skip the loop for empty bucket
         #ifdef DEBUG
@@ -395,6 +1131,12 @@ uint64_t* async_radix_sort_hNd( const uint64_t u_list [], uint32_t l_size,
         th_args_list[b].bucket = &bucket_lN[b];
         th_args_list[b].digit_h_N = digit_h_N -1;
         th_args_list[b].soi_f = &soi_fifos[b];
+        th_args_list[b].s_list = s_list;
+        th_args_list[b].s_order = sort_order;
+        // Descending order fill the sorted list from the end
+        th_args_list[b].s_offset = (sort_order == 'd') ?
+            (l_size - s_offset - bucket_lN[b].wp) : s_offset;
+        s_offset += bucket_lN[b].wp;
         // Start a thread for each bucket with argument
         int rc = pthread_create(
             &threads[b], NULL,
@@ -403,6 +1145,10 @@ uint64_t* async_radix_sort_hNd( const uint64_t u_list [], uint32_t l_size,
         );
         if(rc) {
             printf("Error creating thread %d: %s\n", b, strerror(rc));
+            // Wait for the started threads before free their memory
+            for(uint8_t j = 0; j < b; ++j)
+                if( bucket_lN[j].wp != 0 )  pthread_join(threads[j], NULL);
+            free(s_list);  s_list = NULL;
             free_2buckets(soi_fifos, bucket_lN);  // Free memory before return
             return NULL; // Return NULL on error
         }
@@ -413,10 +1159,12 @@ uint64_t* async_radix_sort_hNd( const uint64_t u_list [], uint32_t l_size,
         int rc = pthread_join(threads[b], NULL);
         if(rc) {
             printf("Error joining thread %d: %s\n", b, strerror(rc));
+            free(s_list);  s_list = NULL;
             free_2buckets(soi_fifos, bucket_lN);  // Free memory before return
             return NULL; // Return NULL on error
         }
     }
+    PERF_END(PERF_PHASE_RECUR);
     //-
     #ifdef DEBUG_L2
     for(uint8_t b = 0; b < NUMBER_OF_BUCKETS; ++b) {
@@ -428,24 +1176,379 @@ uint64_t* async_radix_sort_hNd( const uint64_t u_list [], uint32_t l_size,
         puts("");
     }
     #endif
-    free_buckets(bucket_lN, NUMBER_OF_BUCKETS);
-    // Dynamically allocate memory for sorted list which must be same size 
-    // and length as unsorted list
-    uint64_t *s_list = malloc(sizeof(uint64_t) * l_size);
-    if (s_list == NULL) {
-        printf("Memory allocation failed for sorted list.\n");
-        free_buckets(soi_fifos, NUMBER_OF_BUCKETS);  // Free before return
-        return NULL; // Return NULL on error
+    // The sequences of indices of all buckets and the sorted list
+    const void *hp_bufs[NUMBER_OF_BUCKETS + 1];
+    size_t hp_bytes[NUMBER_OF_BUCKETS + 1];
+    for(uint8_t b = 0; b < NUMBER_OF_BUCKETS; ++b) {
+        hp_bufs[b] = soi_fifos[b].fdata;
+        hp_bytes[b] = sizeof(uint32_t) * bucket_lN[b].wp;
     }
-    async_merge_sList(u_list, soi_fifos, sort_order, s_list);
-    //-
+    hp_bufs[NUMBER_OF_BUCKETS] = s_list;
+    hp_bytes[NUMBER_OF_BUCKETS] = sizeof(uint64_t) * l_size;
+    note_huge_pages(hp_bufs, hp_bytes, NUMBER_OF_BUCKETS + 1);
+    free_buckets(bucket_lN, NUMBER_OF_BUCKETS);
     free_buckets(soi_fifos, NUMBER_OF_BUCKETS);
     return s_list;
 }
+
+// ======================================================================== //
+// Non-blocking sort submission to a shared worker pool
+// ------------------------------------------------------------------------ //
+// The shared pool, a bounded ring queue of submitted jobs with its workers
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;    // Signal workers when a job is queued
+    pthread_t workers[SORT_POOL_MAX_WORKERS];
+    uint8_t n_workers;           // Number of started workers, 0 if stopped
+    uint8_t stop;                // Workers exit when the queue is empty
+    sort_job_t **queue;          // Ring queue of submitted jobs
+    uint32_t q_cap, q_head, q_len;
+} sort_pool = { .lock = PTHREAD_MUTEX_INITIALIZER,
+                .not_empty = PTHREAD_COND_INITIALIZER };
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+static void* sort_pool_worker( void *unused )
+{
+    (void)unused;
+    for (;;) {
+        pthread_mutex_lock(&sort_pool.lock);
+        while (sort_pool.q_len == 0 && !sort_pool.stop)
+            pthread_cond_wait(&sort_pool.not_empty, &sort_pool.lock);
+        if (sort_pool.q_len == 0) {  // Stopped and nothing left to sort
+            pthread_mutex_unlock(&sort_pool.lock);
+            return NULL;
+        }
+        sort_job_t *job = sort_pool.queue[sort_pool.q_head];
+        sort_pool.q_head = (sort_pool.q_head + 1) % sort_pool.q_cap;
+        sort_pool.q_len -= 1;
+        pthread_mutex_unlock(&sort_pool.lock);
+
+        uint64_t *s_list = recur_radix_sort_hNd(job->u_list, job->l_size,
+            job->digit_h_N, job->sort_order);
+        // Notify by callback first, the job can be freed after it is done
+        if (job->done_cb != NULL)  job->done_cb(s_list, job->user_data);
+        pthread_mutex_lock(&job->lock);
+        job->s_list = s_list;
+        radsort_get_stats(&job->stats);
+        job->done = 1;
+        pthread_cond_broadcast(&job->cond);
+        pthread_mutex_unlock(&job->lock);
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+uint8_t sort_pool_init( uint8_t n_workers, uint32_t queue_cap )
+{
+    if (n_workers == 0 || n_workers > SORT_POOL_MAX_WORKERS || queue_cap == 0) {
+        printf("Worker pool needs 1 to %d workers and a non-empty queue.\n",
+            SORT_POOL_MAX_WORKERS);
+        return 0;
+    }
+    pthread_mutex_lock(&sort_pool.lock);
+    if (sort_pool.n_workers != 0) {  // Already started, keep it as it is
+        uint8_t started = sort_pool.n_workers;
+        pthread_mutex_unlock(&sort_pool.lock);
+        return started;
+    }
+    sort_pool.queue = malloc(sizeof(sort_job_t *) * queue_cap);
+    if (sort_pool.queue == NULL) {
+        printf("Failed to allocate memory.\n");
+        pthread_mutex_unlock(&sort_pool.lock);
+        return 0;
+    }
+    sort_pool.q_cap = queue_cap;
+    sort_pool.q_head = 0;
+    sort_pool.q_len = 0;
+    sort_pool.stop = 0;
+    for (uint8_t w = 0; w < n_workers; ++w) {
+        int rc = pthread_create(&sort_pool.workers[w], NULL,
+                                sort_pool_worker, NULL);
+        if (rc) {
+            printf("Error creating worker %d: %s\n", w, strerror(rc));
+            break;
+        }
+        sort_pool.n_workers += 1;
+    }
+    uint8_t started = sort_pool.n_workers;
+    if (started == 0) {
+        free(sort_pool.queue);  sort_pool.queue = NULL;
+    }
+    pthread_mutex_unlock(&sort_pool.lock);
+    return started;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+void sort_pool_destroy( void )
+{
+    pthread_mutex_lock(&sort_pool.lock);
+    uint8_t n_workers = sort_pool.n_workers;
+    sort_pool.stop = 1;
+    pthread_cond_broadcast(&sort_pool.not_empty);
+    pthread_mutex_unlock(&sort_pool.lock);
+    // Workers finish the queued jobs before exit
+    for (uint8_t w = 0; w < n_workers; ++w)
+        pthread_join(sort_pool.workers[w], NULL);
+    pthread_mutex_lock(&sort_pool.lock);
+    sort_pool.n_workers = 0;
+    free(sort_pool.queue);  sort_pool.queue = NULL;
+    sort_pool.q_cap = 0;
+    pthread_mutex_unlock(&sort_pool.lock);
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+sort_job_t* radsort_submit( const uint64_t u_list [], uint32_t l_size,
+        uint8_t digit_h_N, char sort_order, radsort_done_cb done_cb,
+        void *user_data )
+{
+    if (digit_h_N == 0 || digit_h_N > 16) {
+        printf("Maximum hexadcimal digit can be 16. Current digit is %d.\n",
+            digit_h_N);
+        errno = EINVAL;
+        return NULL;
+    }
+    pthread_mutex_lock(&sort_pool.lock);
+    if (sort_pool.n_workers == 0 || sort_pool.stop ||
+        sort_pool.q_len == sort_pool.q_cap) {
+        // Only a full queue is temporary, the caller should retry later.
+        // Nothing is allocated yet, so a rejected submission is cheap.
+        errno = (sort_pool.n_workers == 0 || sort_pool.stop) ? EINVAL : EAGAIN;
+        pthread_mutex_unlock(&sort_pool.lock);
+        return NULL;
+    }
+    // The job is made under the pool lock, so its queue slot is kept
+    sort_job_t *job = calloc(1, sizeof(sort_job_t));
+    if (job == NULL) {
+        pthread_mutex_unlock(&sort_pool.lock);
+        printf("Failed to allocate memory.\n");
+        errno = ENOMEM;
+        return NULL;
+    }
+    job->u_list = u_list;
+    job->l_size = l_size;
+    job->digit_h_N = digit_h_N;
+    job->sort_order = sort_order;
+    job->done_cb = done_cb;
+    job->user_data = user_data;
+    pthread_mutex_init(&job->lock, NULL);
+    pthread_cond_init(&job->cond, NULL);
+    uint32_t tail = (sort_pool.q_head + sort_pool.q_len) % sort_pool.q_cap;
+    sort_pool.queue[tail] = job;
+    sort_pool.q_len += 1;
+    pthread_cond_signal(&sort_pool.not_empty);
+    pthread_mutex_unlock(&sort_pool.lock);
+    return job;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+uint8_t radsort_poll( sort_job_t *job )
+{
+    if (job == NULL)  return 0;
+    pthread_mutex_lock(&job->lock);
+    uint8_t done = job->done;
+    pthread_mutex_unlock(&job->lock);
+    return done;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+uint64_t* radsort_wait( sort_job_t *job )
+{
+    if (job == NULL)  return NULL;
+    pthread_mutex_lock(&job->lock);
+    while (!job->done)
+        pthread_cond_wait(&job->cond, &job->lock);
+    pthread_mutex_unlock(&job->lock);
+    uint64_t *s_list = job->s_list;
+    sort_stats = job->stats;  // Statistics of the job for the caller thread
+    pthread_cond_destroy(&job->cond);
+    pthread_mutex_destroy(&job->lock);
+    free(job);
+    return s_list;
+}
+// ------------------------------------------------------------------------ //
 #endif // ASYNC_SORT_ENABLED
 // ------------------------------------------------------------------------ //
 
 
+// ======================================================================== //
+// Automatic selection of sort engine
+// ------------------------------------------------------------------------ //
+// Counting sort of 64-bit numbers which fit in 4 hex digits, for auto plan
+static uint64_t* count_sort_u64( const uint64_t u_list [], uint32_t l_size,
+        uint8_t digit_h_N, char sort_order );
+RADSORT_DEFINE_COUNT_SORT(count_sort_u64, uint64_t, 4)
+
+// Thresholds of auto plan, can be changed by radsort_set_auto_cfg()
+static radsort_auto_cfg_t auto_cfg = {
+    AUTO_SMALL_SORT_SIZE, AUTO_COUNT_SORT_RATIO, AUTO_ASYNC_SORT_SIZE,
+    AUTO_SAMPLE_SIZE, AUTO_DUPLICATE_PCT
+};
+
+void radsort_set_auto_cfg( const radsort_auto_cfg_t *cfg )
+{
+    if (cfg != NULL) {
+        auto_cfg = *cfg;
+    } else {
+        radsort_auto_cfg_t dflt_cfg = {
+            AUTO_SMALL_SORT_SIZE, AUTO_COUNT_SORT_RATIO, AUTO_ASYNC_SORT_SIZE,
+            AUTO_SAMPLE_SIZE, AUTO_DUPLICATE_PCT
+        };
+        auto_cfg = dflt_cfg;
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+static int compare_u64( const void *a, const void *b )
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+uint64_t* radix_sort_auto( const uint64_t u_list [], uint32_t l_size,
+        char sort_order )
+{
+    if(sort_order != 'a' && sort_order != 'd') {
+        printf("Wrong sort order input '%c'. Default ascending order used.\n",
+            sort_order);
+        sort_order = 'a';
+    }
+    radsort_auto_cfg_t cfg = auto_cfg;
+    radsort_stats_t plan;
+    memset(&plan, 0, sizeof(radsort_stats_t));
+    plan.small_sort_size = cfg.small_sort_size;
+
+    // One sequential pass for the maximum number and the presortedness
+    uint64_t max_num = 0;
+    uint32_t n_asc = 0, n_desc = 0;  // Number of ascending/descending pairs
+    for (uint32_t i = 0; i < l_size; ++i) {
+        if (u_list[i] > max_num)  max_num = u_list[i];
+        if (i > 0) {
+            n_asc += (u_list[i-1] < u_list[i]);
+            n_desc += (u_list[i-1] > u_list[i]);
+        }
+    }
+    plan.digit_h_N = 1;
+    while (plan.digit_h_N < 16 && (max_num >> (plan.digit_h_N << 2)) != 0)
+        plan.digit_h_N += 1;
+    plan.sorted_pct = (l_size > 1) ? 
+        (uint8_t)(100 - (uint64_t)n_desc * 100 / (l_size - 1)) : 100;
+
+    // Sample evenly spaced numbers for duplicate rate and top level buckets
+    uint32_t n_sample = (l_size < cfg.sample_size) ? l_size : cfg.sample_size;
+    if (n_sample > 0) {
+        uint64_t *sample = malloc(sizeof(uint64_t) * n_sample);
+        check_mem_alloc(sample);
+        uint16_t top_digits = 0;  // A bit for each non-empty top bucket
+        uint8_t top_shift = (plan.digit_h_N - 1) << 2;
+        for (uint32_t i = 0; i < n_sample; ++i) {
+            sample[i] = u_list[(uint64_t)i * l_size / n_sample];
+            top_digits |= 1u << ((sample[i] >> top_shift) & 0x0F);
+        }
+        qsort(sample, n_sample, sizeof(uint64_t), compare_u64);
+        uint32_t n_distinct = 1;
+        for (uint32_t i = 1; i < n_sample; ++i)
+            n_distinct += (sample[i] != sample[i-1]);
+        free(sample);  sample = NULL;
+        plan.dup_pct = (uint8_t)(100 - (uint64_t)n_distinct * 100 / n_sample);
+        plan.n_threads = (uint8_t)__builtin_popcount(top_digits);
+    }
+    plan.sample_size = n_sample;
+
+    // Make the plan from the sampled figures
+    if (l_size <= cfg.small_sort_size) {
+        plan.engine = RADSORT_ENGINE_SMALL;
+    } else if (n_desc == 0 || n_asc == 0) {
+        plan.engine = RADSORT_ENGINE_PRESORTED;
+    } else if (plan.digit_h_N <= 4 && (uint64_t)l_size * cfg.count_sort_ratio
+                >= (1u << (plan.digit_h_N << 2))) {
+        plan.engine = RADSORT_ENGINE_COUNT;
+    } else if (plan.dup_pct >= cfg.duplicate_pct) {
+        plan.engine = RADSORT_ENGINE_UNIQUE;
+    #ifdef ASYNC_SORT_ENABLED
+    } else if (l_size >= cfg.async_sort_size && plan.n_threads > 1 &&
+               worker_count() > 1) {
+        plan.engine = RADSORT_ENGINE_ASYNC;
+    #endif
+    } else {
+        plan.engine = RADSORT_ENGINE_RECUR;
+    }
+    if (plan.engine != RADSORT_ENGINE_ASYNC)  plan.n_threads = 1;
+
+    uint64_t *s_list = NULL;
+    switch (plan.engine) {
+    case RADSORT_ENGINE_SMALL:
+    case RADSORT_ENGINE_PRESORTED:
+        reset_sort_stats();
+        s_list = malloc(sizeof(uint64_t) * (l_size ? l_size : 1));
+        check_mem_alloc(s_list);
+        // Copy the list in sort order, a sorted list is only reversed
+        uint8_t reverse = (plan.engine == RADSORT_ENGINE_PRESORTED) &&
+            ((sort_order == 'a') ? (n_asc == 0 && n_desc > 0) : (n_desc == 0));
+        for (uint32_t i = 0; i < l_size; ++i)
+            s_list[i] = reverse ? u_list[l_size - 1 - i] : u_list[i];
+        if (plan.engine == RADSORT_ENGINE_SMALL) {
+            for (uint32_t i = 1; i < l_size; ++i) {
+                uint64_t num = s_list[i];
+                uint32_t j = i;
+                for (; j > 0 && ((sort_order == 'd') ? (s_list[j-1] < num) :
+                                                       (s_list[j-1] > num)); --j)
+                    s_list[j] = s_list[j-1];
+                s_list[j] = num;
+            }
+        }
+        break;
+    case RADSORT_ENGINE_COUNT:
+        s_list = count_sort_u64(u_list, l_size, plan.digit_h_N, sort_order);
+        break;
+    case RADSORT_ENGINE_UNIQUE: {
+        // Sort the unique numbers, then repeat each one by its count
+        uint32_t *counts = NULL, n_unique = 0;
+        uint64_t *uq_list = radix_sort_unique_count(u_list, l_size,
+            plan.digit_h_N, sort_order, &counts, &n_unique);
+        if (uq_list == NULL)  break;
+        s_list = malloc(sizeof(uint64_t) * l_size);
+        if (s_list != NULL) {
+            uint32_t s_cnt = 0;
+            for (uint32_t u = 0; u < n_unique; ++u)
+                for (uint32_t c = 0; c < counts[u]; ++c)
+                    s_list[s_cnt++] = uq_list[u];
+        } else {
+            printf("Failed to allocate memory.\n");
+        }
+        free(counts);  counts = NULL;
+        free(uq_list);  uq_list = NULL;
+        break;
+    }
+    #ifdef ASYNC_SORT_ENABLED
+    case RADSORT_ENGINE_ASYNC:
+        s_list = async_radix_sort_hNd(u_list, l_size, plan.digit_h_N,
+            sort_order);
+        break;
+    #endif
+    default:
+        s_list = recur_radix_sort_hNd(u_list, l_size, plan.digit_h_N,
+            sort_order);
+        break;
+    }
+    // Keep the allocation statistics of the engine and add the plan
+    plan.hp_buffers = sort_stats.hp_buffers;
+    plan.huge_pages = sort_stats.huge_pages;
+    plan.huge_page_bytes = sort_stats.huge_page_bytes;
+    plan.prefault_bytes = sort_stats.prefault_bytes;
+    sort_stats = plan;
+    return s_list;
+}
+// ------------------------------------------------------------------------ //
+
+
 // ======================================================================== //
 // Print some head part and some tail part of an array
 // l_size is then number of elements (last index+1)
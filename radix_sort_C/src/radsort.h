@@ -56,6 +56,23 @@ extern "C" {
 // #define DEBUG_L2 
 
 // #define ASYNC_SORT_ENABLED  // Enable multi thread sorting feature
+// #define PREFAULT_ENABLED  // Enable page prefault of large sort buffers
+// #define HUGE_PAGE_STATS_ENABLED  // Read huge page usage of sort buffers
+
+/**
+ * @brief The macros for huge page allocation of large sort buffers
+ * @details A sort buffer (sequence of indices and sorted list) which is
+ * equal or larger than HUGE_PAGE_THRESHOLD bytes is aligned to HUGE_PAGE_SIZE
+ * and advised to use transparent huge pages, so the hot loops take less page
+ * faults and TLB misses. The buckets are not advised, since they are
+ * allocated with full list size but only few of their pages are used.
+ * If PREFAULT_ENABLED is defined, the pages are also touched before use, in
+ * parallel by worker threads if ASYNC_SORT_ENABLED is defined. If
+ * HUGE_PAGE_STATS_ENABLED is defined, the bytes of these buffers which are
+ * backed by huge pages are read from /proc/self/smaps once after each sort.
+ */
+#define HUGE_PAGE_SIZE      (2UL << 20)   // 2 MiB
+#define HUGE_PAGE_THRESHOLD (64UL << 20)  // 64 MiB
 
 /**
  * @brief The macro for number of buckets
@@ -65,6 +82,44 @@ extern "C" {
  */
 #define NUMBER_OF_BUCKETS 16
 
+/**
+ * @brief The macro for maximum number of items of a small bucket
+ * @details A bucket with this number of items or less is sorted by insertion
+ * sort of its indices in the bucket radix sort of all key widths, since
+ * making 16 new buckets for each remaining digit costs more than sorting few
+ * items. A segment of radix_sort_segments() with this number of items or
+ * less is also sorted by insertion sort instead of the counting passes.
+ */
+#define SMALL_BUCKET_SIZE 32
+
+/**
+ * @brief The macros for default thresholds of automatic engine selection
+ * @details See radsort_auto_cfg_t for the meaning of each threshold.
+ */
+#define AUTO_SMALL_SORT_SIZE   32
+#define AUTO_COUNT_SORT_RATIO  4
+#define AUTO_ASYNC_SORT_SIZE   (1u << 20)
+#define AUTO_SAMPLE_SIZE       1024
+#define AUTO_DUPLICATE_PCT     90
+
+/**
+ * @brief The macro for minimum number of items of segmented sort to use
+ * multiple threads
+ * @details The segments of radix_sort_segments() are sorted by multiple
+ * threads only if ASYNC_SORT_ENABLED is defined and the total number of items
+ * of all segments is equal or larger than this value.
+ */
+#define SEGMENT_PARALLEL_SIZE (1u << 16)
+
+/**
+ * @brief The macro for minimum number of items of merge-insert to use
+ * multiple threads
+ * @details The out-of-place merge of radix_merge_insert() is split by the
+ * top digit and merged by multiple threads only if ASYNC_SORT_ENABLED is
+ * defined and the total number of items is equal or larger than this value.
+ */
+#define MERGE_PARALLEL_SIZE   (1u << 16)
+
 /**
  * @brief Check the success of memory allocation
  * @details This macro check the success of memory allocation. If the
@@ -182,6 +237,98 @@ typedef struct {
     uint32_t wp;     // write pointer
 } spfifo_t;
 
+/**
+ * @brief Statistics of the last sort of the calling thread
+ * @details The sort functions reset this statistics at the begining, and
+ * record the allocation of large sort buffers. It can be read by
+ * radsort_get_stats() after the sort function returns.
+ */
+typedef struct {
+    uint32_t hp_buffers;       // Number of buffers advised to use huge pages
+    // Only filled if HUGE_PAGE_STATS_ENABLED is defined
+    uint8_t huge_pages;        // 1 if huge pages were obtained, otherwise 0
+    size_t huge_page_bytes;    // Bytes of sort buffers backed by huge pages
+    size_t prefault_bytes;     // Bytes of sort buffers prefaulted before use
+    // The plan of radix_sort_auto(), all zero for other sort functions
+    uint8_t engine;            // The chosen engine (radsort_engine_t)
+    uint8_t digit_h_N;         // The chosen maximum length of digit
+    // Estimate of threads: non-empty top buckets of the sample for the
+    // async engine (it starts a thread per non-empty bucket), otherwise 1
+    uint8_t n_threads;
+    uint8_t dup_pct;           // Percent of duplicate numbers in the sample
+    uint8_t sorted_pct;        // Percent of non-descending adjacent pairs
+    uint32_t sample_size;      // The number of sampled numbers
+    uint32_t small_sort_size;  // Size cutoff of the insertion sort engine
+} radsort_stats_t;
+
+/**
+ * @brief The sort engines which can be chosen by radix_sort_auto()
+ */
+typedef enum {
+    RADSORT_ENGINE_NONE = 0,   // Not planned by radix_sort_auto()
+    RADSORT_ENGINE_SMALL,      // Insertion sort of a small list
+    RADSORT_ENGINE_PRESORTED,  // Copy (or reverse) an already sorted list
+    RADSORT_ENGINE_COUNT,      // Counting sort of numbers up to 4 hex digits
+    RADSORT_ENGINE_UNIQUE,     // radix_sort_unique_count() and expand counts
+    RADSORT_ENGINE_RECUR,      // recur_radix_sort_hNd()
+    RADSORT_ENGINE_ASYNC       // async_radix_sort_hNd()
+} radsort_engine_t;
+
+/**
+ * @brief The thresholds of radix_sort_auto() to choose the engine
+ * @details The default values are the AUTO_* macros, and can be changed by
+ * radsort_set_auto_cfg() for all following calls.
+ */
+typedef struct {
+    uint32_t small_sort_size;  // Insertion sort up to this list size
+    uint32_t count_sort_ratio; // Counting sort if size*ratio >= 16^digits
+    uint32_t async_sort_size;  // Multi thread sort from this list size
+    uint32_t sample_size;      // Number of sampled numbers
+    uint8_t duplicate_pct;     // Unique count engine from this duplicate %
+} radsort_auto_cfg_t;
+
+/**
+ * @brief Structure for arguments of sorting a range of segments
+ * @details This structure is used to pass the arguments of segmented sort to
+ * the function which sort a range of segments, directly or by a thread. Each
+ * range has its own scratch buffer which is shared by all of its segments.
+ */
+typedef struct {
+    const uint64_t *u_list;    // Pointer to the unsorted list of all segments
+    const uint32_t *seg_offs;  // Offsets of segments, n_segs+1 items
+    uint32_t seg_begin;        // The first segment of the range
+    uint32_t seg_end;          // The segment after the last one of the range
+    uint8_t digit_h_N;         // The maximum length of digit of numbers
+    char s_order;              // The sort order
+    uint64_t *s_list;          // Pointer to the sorted list of all segments
+    uint64_t *scratch;         // Scratch buffer for the largest segment
+} seg_args_t;
+
+/**
+ * @brief Structure for arguments of merging a part of two sorted lists
+ * @details This structure is used to pass the arguments of out-of-place
+ * merge-insert to the function which merge one part (a range of top digit) of
+ * the sorted list and the sorted batch, directly or by a thread.
+ */
+typedef struct {
+    const uint64_t *s_list;    // Pointer to the first item of sorted list part
+    uint32_t s_size;           // The number of items of sorted list part
+    const uint64_t *b_list;    // Pointer to the first item of batch part
+    uint32_t b_size;           // The number of items of batch part
+    char s_order;              // The sort order
+    uint64_t *out;             // Pointer to the output of this part
+} merge_args_t;
+
+#ifdef PREFAULT_ENABLED
+/**
+ * @brief Structure for thread function arguments of page prefault
+ */
+typedef struct {
+    uint8_t *start;  // Start address of the part of buffer
+    size_t len;      // Length of the part of buffer in bytes
+} prefault_args_t;
+#endif
+
 // ======================================================================== //
 // Function declaration
 // ======================================================================== //
@@ -275,6 +422,115 @@ uint64_t *radix_sort_h4d(const uint64_t u_list[], uint32_t l_size,
 uint64_t *recur_radix_sort_hNd(const uint64_t u_list[], uint32_t l_size,
                                 uint8_t digit_h_N, char sort_order);
 
+/**
+ * @brief The functions sort unsorted list of narrow (8/16/32-bit) integer
+ * numbers without widen them into a uint64_t list.
+ *
+ * @details The 8-bit and 16-bit variants use a single counting pass with
+ * 16^digit_h_N counters, since the whole key range fits into a small table.
+ * The 32-bit variant use the same bucket algorithm of recur_radix_sort_hNd()
+ * (generated from the same code by macro) with the native key width, so the
+ * memory traffic of key access is halved. The maximum length of digit is 2,
+ * 4 and 8 in hexadecimal respectively.
+ *
+ * @param u_list Unsorted list
+ * @param l_size The size of the unsorted list
+ * @param digit_h_N The maximum length of digit of number in unsorted list
+ * @param sort_order The order of sorting (Ascending or Descending order)
+ *
+ * @return Array of sorted numbers with the same type of unsorted list
+ */
+uint8_t *recur_radix_sort_hNd_u8(const uint8_t u_list[], uint32_t l_size,
+                                uint8_t digit_h_N, char sort_order);
+uint16_t *recur_radix_sort_hNd_u16(const uint16_t u_list[], uint32_t l_size,
+                                uint8_t digit_h_N, char sort_order);
+uint32_t *recur_radix_sort_hNd_u32(const uint32_t u_list[], uint32_t l_size,
+                                uint8_t digit_h_N, char sort_order);
+
+/**
+ * @brief The function select first k numbers of the sort order (k smallest
+ * for ascending or k largest for descending order) and sort them.
+ *
+ * @details This function make the top level buckets like
+ * recur_radix_sort_hNd(). Then it visit the buckets in sort order, a bucket
+ * which is fully inside the first k ranks is sorted fully, the only bucket
+ * which hold the k-th rank is split again, and all buckets after that are
+ * skipped without any more bucketing. So the work is nearly one pass of
+ * radix_pos() for a small k.
+ *
+ * @param u_list Unsorted list
+ * @param l_size The size of the unsorted list
+ * @param digit_h_N The maximum length of digit of number in unsorted list
+ * @param k The number of selected numbers (1 to l_size)
+ * @param sort_order The order of sorting (Ascending or Descending order)
+ *
+ * @return uint64_t* Array of k sorted numbers
+ */
+uint64_t *radix_topk(const uint64_t u_list[], uint32_t l_size,
+                        uint8_t digit_h_N, uint32_t k, char sort_order);
+
+/**
+ * @brief The function partially sort unsorted list, only first k numbers
+ * are sorted.
+ *
+ * @details Same as radix_topk(), but the returned list has all l_size
+ * numbers. First k numbers are sorted and the rest of the numbers follow
+ * them in unspecified order (the skipped buckets are not sorted).
+ *
+ * @param u_list Unsorted list
+ * @param l_size The size of the unsorted list
+ * @param digit_h_N The maximum length of digit of number in unsorted list
+ * @param k The number of sorted numbers from the begining (1 to l_size)
+ * @param sort_order The order of sorting (Ascending or Descending order)
+ *
+ * @return uint64_t* Array of partially sorted numbers
+ */
+uint64_t *radix_partial_sort(const uint64_t u_list[], uint32_t l_size,
+                        uint8_t digit_h_N, uint32_t k, char sort_order);
+
+/**
+ * @brief The function find the number which would be at nth position if the
+ * list is sorted (e.g. median or p99 value).
+ *
+ * @details At each digit only the bucket which hold the nth rank is split
+ * again, all others are dropped. No sorted list is allocated, the unsorted
+ * list is not modified.
+ *
+ * @param u_list Unsorted list
+ * @param l_size The size of the unsorted list
+ * @param digit_h_N The maximum length of digit of number in unsorted list
+ * @param nth The rank (index of sorted list, 0 to l_size-1)
+ * @param sort_order The order of sorting (Ascending or Descending order)
+ *
+ * @return const uint64_t* Pointer to the nth number inside unsorted list
+ */
+const uint64_t *radix_nth_element(const uint64_t u_list[], uint32_t l_size,
+                        uint8_t digit_h_N, uint32_t nth, char sort_order);
+
+#if !defined(__cplusplus) && defined(__STDC_VERSION__) && \
+    (__STDC_VERSION__ >= 201112L)
+/**
+ * @brief Type-generic radix sort by the key type of unsorted list
+ * @details This macro select the specialized function for the key width of
+ * the unsorted list by C11 _Generic, e.g. a uint16_t list is sorted by
+ * recur_radix_sort_hNd_u16() and a uint64_t list by recur_radix_sort_hNd().
+ * A list of any other type (e.g. int64_t or int) is a compile error, so it
+ * is not sorted by a function of wrong key type. Only available for C11 or
+ * newer C compiler.
+ */
+#define radix_sort_hNd(u_list, l_size, digit_h_N, sort_order)                \
+    _Generic((u_list),                                                       \
+        uint8_t *:        recur_radix_sort_hNd_u8,                           \
+        const uint8_t *:  recur_radix_sort_hNd_u8,                           \
+        uint16_t *:       recur_radix_sort_hNd_u16,                          \
+        const uint16_t *: recur_radix_sort_hNd_u16,                          \
+        uint32_t *:       recur_radix_sort_hNd_u32,                          \
+        const uint32_t *: recur_radix_sort_hNd_u32,                          \
+        uint64_t *:       recur_radix_sort_hNd,                              \
+        const uint64_t *: recur_radix_sort_hNd                               \
+    )(u_list, l_size, digit_h_N, sort_order)
+#endif
+
 
 
 #ifdef ASYNC_SORT_ENABLED
@@ -284,14 +540,18 @@ uint64_t *recur_radix_sort_hNd(const uint64_t u_list[], uint32_t l_size,
  * @brief Structure for thread function arguments in asynchronous radix sort.
  * @details This structure is used to pass multiple arguments to a thread 
  * function when performing asynchronous radix sort. It contains pointers to 
- * the unsorted list, the current bucket, the current digit's place value, and 
- * the sequence of indices FIFO where the merged indices will be stored.
+ * the unsorted list, the current bucket, the current digit's place value, 
+ * the sequence of indices FIFO where the merged indices will be stored, and
+ * the place of this bucket in the sorted list where the thread copy numbers.
  */
 typedef struct _thread_args_t {
     const uint64_t *u_list;  // Pointer to the unsorted list of numbers
     const spfifo_t *bucket;  // Pointer to the current bucket being processed
     uint8_t digit_h_N;  // The current digit's place value
     spfifo_t *soi_f;  // Pointer to the sequence of indices for store indices
+    uint64_t *s_list;  // Pointer to the sorted list, shared by all threads
+    uint32_t s_offset;  // Position of this bucket's first item in s_list
+    char s_order;  // The sort order of the sorted list
 } thread_args_t;
 
 /**
@@ -302,8 +562,9 @@ typedef struct _thread_args_t {
  * (asynchronous) manner. It first creates an array of top-level buckets based 
  * on the maximum digit length. For each non-empty bucket, it spawns a 
  * separate thread to recursively process and merge indices using a thread 
- * argument structure. After all threads complete, it merges the sorted 
- * indices from all buckets into a single sorted list. This approach leverages 
+ * argument structure. The output position of each bucket is the prefix sum 
+ * of the sizes of top-level buckets, so each thread copies its own numbers 
+ * into the sorted list as soon as it finishes. This approach leverages 
  * parallelism to improve sorting performance for large datasets. The maximum 
  * length of digit is 16 in hexadecimal (0xFFFF_FFFF_FFFF_FFFF or 
  * 18,446,744,073,709,551,615).
@@ -318,10 +579,240 @@ typedef struct _thread_args_t {
 uint64_t* async_radix_sort_hNd( const uint64_t u_list [], uint32_t l_size, 
         uint8_t digit_h_N, char sort_order );
 
+/**
+ * @brief The macro for maximum number of workers of the shared sort pool
+ */
+#define SORT_POOL_MAX_WORKERS NUMBER_OF_BUCKETS
+
+/**
+ * @brief Completion callback of a submitted sort
+ * @details It is called by the worker thread with the sorted list (or NULL
+ * on error) and the user data of radsort_submit(), just before the job is
+ * done. It must not call radsort_wait() for the same job, it is for waking
+ * up an event loop which will call radsort_poll() or radsort_wait().
+ */
+typedef void (*radsort_done_cb)(uint64_t *s_list, void *user_data);
+
+/**
+ * @brief Handle of a sort which is submitted to the shared sort pool
+ * @details The handle is returned by radsort_submit(), and freed by
+ * radsort_wait() which must be called once for each handle.
+ */
+typedef struct _sort_job_t {
+    const uint64_t *u_list;    // Unsorted list, must live until done
+    uint32_t l_size;           // The size of the unsorted list
+    uint8_t digit_h_N;         // The maximum length of digit
+    char sort_order;           // The sort order
+    radsort_done_cb done_cb;   // Completion callback or NULL
+    void *user_data;           // User data for the callback
+    uint64_t *s_list;          // Sorted list, valid when done
+    radsort_stats_t stats;     // Statistics of the sort, valid when done
+    uint8_t done;              // 1 when the sort is finished
+    pthread_mutex_t lock;      // Lock of done, s_list and stats
+    pthread_cond_t cond;       // Signal radsort_wait() when done
+} sort_job_t;
+
+/**
+ * @brief The function start the shared sort pool.
+ *
+ * @details The pool has a fixed number of worker threads and a bounded
+ * queue of submitted sorts. Each worker sort one list at a time by
+ * recur_radix_sort_hNd(), so several sorts are in flight together. If the
+ * pool is already started, it is kept as it is.
+ *
+ * @param n_workers The number of worker threads (1 to SORT_POOL_MAX_WORKERS)
+ * @param queue_cap The maximum number of sorts waiting in the queue
+ * @return uint8_t The number of started workers, 0 on error
+ */
+uint8_t sort_pool_init( uint8_t n_workers, uint32_t queue_cap );
+
+/**
+ * @brief The function stop the shared sort pool after all queued sorts are
+ * finished, and join the workers. The handles still need radsort_wait().
+ *
+ * @return void Return nothing
+ */
+void sort_pool_destroy( void );
+
+/**
+ * @brief The function submit a sort to the shared sort pool and return
+ * immediately without waiting for the sort.
+ *
+ * @details If the sort can't be submitted, nothing is submitted and NULL is
+ * returned without blocking, and errno tells the reason. Only a full queue
+ * (backpressure) is temporary, so the caller should retry later only for
+ * EAGAIN. The unsorted list must not be changed or freed until the sort is
+ * done.
+ *
+ * @param u_list Unsorted list
+ * @param l_size The size of the unsorted list
+ * @param digit_h_N The maximum length of digit of number in unsorted list
+ * @param sort_order The order of sorting (Ascending or Descending order)
+ * @param done_cb The completion callback, or NULL for no callback
+ * @param user_data The user data which is passed to the callback
+ *
+ * @return sort_job_t* Handle of the submitted sort, NULL if not submitted
+ * with errno set to:
+ *  - EAGAIN: The queue is full, retry later
+ *  - EINVAL: digit_h_N is not 1 to 16, or the pool is not started (or is
+ *    being destroyed)
+ *  - ENOMEM: Failed to allocate the job
+ */
+sort_job_t* radsort_submit( const uint64_t u_list [], uint32_t l_size,
+        uint8_t digit_h_N, char sort_order, radsort_done_cb done_cb,
+        void *user_data );
+
+/**
+ * @brief The function check a submitted sort is done without blocking.
+ *
+ * @param job Handle of the submitted sort
+ * @return uint8_t 1 if the sort is done, otherwise 0
+ */
+uint8_t radsort_poll( sort_job_t *job );
+
+/**
+ * @brief The function wait until a submitted sort is done, then free the
+ * handle and return the sorted list. It does not block after radsort_poll()
+ * returned 1. The statistics of the sort can be read by radsort_get_stats().
+ *
+ * @param job Handle of the submitted sort
+ * @return uint64_t* Array of sorted numbers, NULL on error
+ */
+uint64_t* radsort_wait( sort_job_t *job );
+
 
 #endif  // ASYNC_SORT
 
 
+/**
+ * @brief The function make sorted list of unique numbers with the number of
+ * occurrence of each number (group-by-count).
+ *
+ * @details This function make buckets same as recur_radix_sort_hNd(), but a
+ * bucket with all same numbers (or a bucket of the last digit) is not split
+ * anymore, only its first number and its number of items are kept. So there
+ * is no sorted list of all numbers and no second pass to count. All numbers
+ * must fit in digit_h_N hex digits, since the numbers of last digit bucket
+ * are taken as same number.
+ *
+ * @param u_list Unsorted list
+ * @param l_size The size of the unsorted list
+ * @param digit_h_N The maximum length of digit of number in unsorted list
+ * @param sort_order The order of sorting (Ascending or Descending order)
+ * @param counts The pointer where the allocated array of counts will be
+ * stored, counts[i] is the number of occurrence of i-th unique number
+ * @param n_unique The pointer where the number of unique numbers is stored
+ *
+ * @return uint64_t* Array of sorted unique numbers, which must be freed even
+ * if n_unique is 0 (empty list)
+ */
+uint64_t *radix_sort_unique_count(const uint64_t u_list[], uint32_t l_size,
+                uint8_t digit_h_N, char sort_order, uint32_t **counts,
+                uint32_t *n_unique);
+
+/**
+ * @brief The function sort many independent segments of a list in one call.
+ *
+ * @details The segments are concatenated in u_list, and the segment i is
+ * u_list[seg_offs[i]] to u_list[seg_offs[i+1]-1]. Each segment is sorted
+ * separately into the same place of s_list. A segment up to
+ * SMALL_BUCKET_SIZE items is sorted by insertion sort, a larger one by
+ * counting pass of 16 buckets for each hex digit (a digit is skipped when all
+ * numbers are in one bucket). The scratch buffer is allocated once and
+ * shared by all segments, so there is no allocation per segment. If
+ * ASYNC_SORT_ENABLED is defined, the segments are split into ranges of
+ * nearly same number of items which are sorted by multiple threads.
+ *
+ * @param u_list Unsorted list of all segments
+ * @param seg_offs The offsets of segments, it has n_segs+1 items and the
+ * last one is the total number of items
+ * @param n_segs The number of segments
+ * @param digit_h_N The maximum length of digit of number in unsorted list
+ * @param sort_order The order of sorting (Ascending or Descending order)
+ * @param s_list The output list with seg_offs[n_segs] items, it can be same
+ * as u_list for in-place sort, or NULL to allocate a new list
+ *
+ * @return uint64_t* Array of sorted segments (s_list or allocated list)
+ */
+uint64_t *radix_sort_segments(const uint64_t u_list[],
+                const uint32_t seg_offs[], uint32_t n_segs,
+                uint8_t digit_h_N, char sort_order, uint64_t *s_list);
+
+/**
+ * @brief The function insert an unsorted batch of numbers into an already
+ * sorted list.
+ *
+ * @details This function sort only the batch by recur_radix_sort_hNd(), then
+ * merge it with the sorted list in one linear pass, so the whole list is not
+ * sorted again. The sorted batch is the only scratch buffer (b_size items).
+ * If out is NULL (or same as s_list) the merge is in place: s_list must have
+ * room for s_size + b_size items, and it is merged from the end, each block
+ * of s_list between two batch numbers is found by galloping search and moved
+ * once by memmove(). Otherwise the merge is written into out, and if
+ * ASYNC_SORT_ENABLED is defined a large merge is split by the top digit into
+ * parts which are merged by multiple threads. The items of s_list stay before
+ * the same numbers of the batch. All numbers must fit in digit_h_N hex
+ * digits, and s_list must be sorted in sort_order.
+ *
+ * @param s_list The sorted list, with capacity of s_size + b_size items for
+ * in-place merge
+ * @param s_size The number of items of the sorted list
+ * @param batch Unsorted batch of new numbers
+ * @param b_size The size of the batch
+ * @param digit_h_N The maximum length of digit of all numbers
+ * @param sort_order The order of sorting (Ascending or Descending order)
+ * @param out The output list with s_size + b_size items, or NULL to merge in
+ * place into s_list
+ *
+ * @return uint64_t* The merged list (s_list or out), NULL on error
+ */
+uint64_t *radix_merge_insert(uint64_t s_list[], uint32_t s_size,
+                const uint64_t batch[], uint32_t b_size,
+                uint8_t digit_h_N, char sort_order, uint64_t *out);
+
+/**
+ * @brief The function sort unsorted list of integer numbers by the engine
+ * which is chosen automatically.
+ *
+ * @details This function first read the list once for the maximum number
+ * (so the length of digit) and the presortedness, and sample some evenly
+ * spaced numbers for the duplicate rate and the number of top level buckets.
+ * Then it choose the engine by the thresholds of radsort_auto_cfg_t:
+ * insertion sort for a small list, copy for an already sorted list, counting
+ * sort for short numbers, unique count for many duplicates, multi thread
+ * sort for a large list (if ASYNC_SORT_ENABLED), otherwise
+ * recur_radix_sort_hNd(). The chosen plan can be read by radsort_get_stats()
+ * after the sort. Its n_threads is only an estimate from the sample, and its
+ * small_sort_size is the threshold of the plan, the engines keep their own
+ * SMALL_BUCKET_SIZE.
+ *
+ * @param u_list Unsorted list
+ * @param l_size The size of the unsorted list
+ * @param sort_order The order of sorting (Ascending or Descending order)
+ *
+ * @return uint64_t* Array of sorted numbers
+ */
+uint64_t *radix_sort_auto(const uint64_t u_list[], uint32_t l_size,
+                            char sort_order);
+
+/**
+ * @brief The function change the thresholds of radix_sort_auto().
+ *
+ * @param cfg The new thresholds, or NULL to restore the default values
+ * @return void Return nothing
+ */
+void radsort_set_auto_cfg( const radsort_auto_cfg_t *cfg );
+
+/**
+ * @brief The function copy the statistics of the last sort which was called
+ * from the current thread.
+ *
+ * @param stats The pointer where the statistics will be copied
+ * @return void Return nothing
+ */
+void radsort_get_stats( radsort_stats_t *stats );
+
+
 /**
  * @brief The function print first and last 4 elements of an array.
  * 
@@ -0,0 +1,252 @@
+/**
+ * @file radsort.hpp
+ * @author Md. Sayeed Al Masud (planetmind@outlook.com)
+ * @brief Header-only C++17 front end of the radix sort
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @details This header sort any random-access range (e.g. std::vector of
+ * records) by an unsigned integer key which is taken by a projection, like
+ * radsort::radix_sort(v.begin(), v.end(), &record_t::id). It use the same
+ * bucketing algorithm of radsort.h: the most significant digit make the top
+ * level buckets, then each bucket is split by the next lower digit, a bucket
+ * with only same keys is not split anymore, and a small bucket is finished
+ * by insertion sort. Each bucket item keeps the key with the position of the
+ * record, so the records are moved only once at the end.
+ * The key width, digit width and sort order are template parameters, so the
+ * loop of each digit is generated with constant shift and bucket count.
+ * Nothing is returned for free(), the range is sorted in place.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Header guard
+#ifndef __RADSORT_HPP__
+#define __RADSORT_HPP__
+
+// ======================================================================== //
+// Include library
+// ======================================================================== //
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace radsort {
+
+// ======================================================================== //
+// Type declaration
+// ======================================================================== //
+/**
+ * @brief The order of sorting
+ */
+enum class order { ascending, descending };
+
+/**
+ * @brief The default projection, which use the value itself as the key
+ */
+struct identity {
+    template <class T>
+    constexpr T &&operator()(T &&t) const noexcept
+    {
+        return std::forward<T>(t);
+    }
+};
+
+namespace detail {
+
+/**
+ * @brief The unsigned integer type of a key width (8, 16, 32 or 64 bits)
+ */
+template <unsigned KeyBits> struct uint_of;
+template <> struct uint_of<8>  { using type = std::uint8_t;  };
+template <> struct uint_of<16> { using type = std::uint16_t; };
+template <> struct uint_of<32> { using type = std::uint32_t; };
+template <> struct uint_of<64> { using type = std::uint64_t; };
+
+/**
+ * @brief The item of a bucket, the key and the position of its record
+ */
+template <class Key>
+struct bucket_item {
+    Key key;
+    std::uint32_t pos;
+};
+
+/**
+ * @brief The maximum number of items of a small bucket, which is sorted by
+ * insertion sort. Same as SMALL_BUCKET_SIZE of radsort.h.
+ */
+constexpr std::size_t small_bucket_size = 32;
+
+// ------------------------------------------------------------------------ //
+// Insertion sort of a small bucket by key, stable
+template <order Order, class Key>
+inline void insertion_sort(bucket_item<Key> *items, std::size_t n)
+{
+    for (std::size_t i = 1; i < n; ++i) {
+        bucket_item<Key> item = items[i];
+        std::size_t j = i;
+        for (; j > 0 && ((Order == order::ascending) ?
+                         (items[j-1].key > item.key) :
+                         (items[j-1].key < item.key)); --j)
+            items[j] = items[j-1];
+        items[j] = item;
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+/**
+ * Sort the items of a bucket by the digit Digit (1 is the lowest digit) and
+ * all lower digits. The items are in src and dst is the scratch buffer of
+ * same size. If in_src is true the sorted items are left in src, otherwise
+ * in dst, so no copy is needed between the levels.
+ */
+template <unsigned Digit, unsigned DigitBits, order Order, class Key>
+void bucket_merge(bucket_item<Key> *src, bucket_item<Key> *dst,
+                  std::size_t n, bool in_src)
+{
+    if constexpr (Digit == 0) {
+        // All digits are used, the items of this bucket have same key
+        if (!in_src)  std::copy(src, src + n, dst);
+    } else {
+        constexpr unsigned n_buckets = 1u << DigitBits;
+        constexpr unsigned shift = (Digit - 1) * DigitBits;
+        constexpr Key mask = static_cast<Key>(n_buckets - 1);
+        if (n <= small_bucket_size) {
+            // Small bucket, insertion sort instead of new buckets
+            insertion_sort<Order>(src, n);
+            if (!in_src)  std::copy(src, src + n, dst);
+            return;
+        }
+        // Count the items of each new bucket
+        std::size_t cnt[n_buckets] = {0};
+        Key first_key = src[0].key;
+        bool same_key = true;
+        for (std::size_t i = 0; i < n; ++i) {
+            cnt[(src[i].key >> shift) & mask] += 1;
+            same_key &= (src[i].key == first_key);
+        }
+        if (same_key) {
+            // All keys are same, skip the rest of digits
+            if (!in_src)  std::copy(src, src + n, dst);
+            return;
+        }
+        if (cnt[(first_key >> shift) & mask] == n) {
+            // All items are in one bucket, go to next digit directly
+            bucket_merge<Digit - 1, DigitBits, Order>(src, dst, n, in_src);
+            return;
+        }
+        // Position of each bucket according to sort order
+        std::size_t pos[n_buckets];
+        std::size_t sum = 0;
+        for (unsigned k = 0; k < n_buckets; ++k) {
+            unsigned b = (Order == order::ascending) ? k : (n_buckets - 1 - k);
+            pos[b] = sum;
+            sum += cnt[b];
+        }
+        for (std::size_t i = 0; i < n; ++i)
+            dst[pos[(src[i].key >> shift) & mask]++] = src[i];
+        // The items are in dst now, split each bucket by the next digit
+        std::size_t begin = 0;
+        for (unsigned k = 0; k < n_buckets; ++k) {
+            unsigned b = (Order == order::ascending) ? k : (n_buckets - 1 - k);
+            if (cnt[b] != 0) {
+                bucket_merge<Digit - 1, DigitBits, Order>(
+                    dst + begin, src + begin, cnt[b], !in_src);
+            }
+            begin += cnt[b];
+        }
+    }
+}
+// ------------------------------------------------------------------------ //
+
+}  // namespace detail
+
+// ======================================================================== //
+// Function declaration
+// ======================================================================== //
+/**
+ * @brief The function sort a random-access range by the key of projection
+ * using radix sort algorithm.
+ *
+ * @details This function first take the key of each record by the
+ * projection (only once per record), then sort the keys with the positions
+ * of records by the buckets of digits from the most significant digit, and
+ * at last move the records into the sorted order. The sort is stable.
+ *
+ * @tparam KeyBits The width of key (8, 16, 32 or 64), 0 for the width of
+ * the projection result
+ * @tparam DigitBits The width of a digit (1 to 8 bits, 4 is hexadecimal)
+ * @tparam Order The order of sorting (Ascending or Descending order)
+ * @param first The begining of the range
+ * @param last The end of the range
+ * @param proj The projection which return an unsigned integer key of a
+ * record, e.g. a pointer to data member or a lambda
+ */
+template <unsigned KeyBits = 0, unsigned DigitBits = 4,
+          order Order = order::ascending, class RandomIt,
+          class Proj = identity>
+void radix_sort(RandomIt first, RandomIt last, Proj proj = {})
+{
+    using value_t = typename std::iterator_traits<RandomIt>::value_type;
+    using reference_t = typename std::iterator_traits<RandomIt>::reference;
+    using proj_t = std::decay_t<std::invoke_result_t<Proj &, reference_t>>;
+    static_assert(std::is_integral_v<proj_t> && std::is_unsigned_v<proj_t>,
+                  "The projection must return an unsigned integer key.");
+    constexpr unsigned key_bits =
+        (KeyBits == 0) ? (unsigned)(sizeof(proj_t) * 8) : KeyBits;
+    static_assert(DigitBits >= 1 && DigitBits <= 8,
+                  "The digit width must be 1 to 8 bits.");
+    static_assert(key_bits % DigitBits == 0,
+                  "The key width must be a multiple of digit width.");
+    using key_t = typename detail::uint_of<key_bits>::type;
+    using item_t = detail::bucket_item<key_t>;
+
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < 2)  return;
+    if (n > std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error("radsort::radix_sort: too many records");
+
+    // Take the key of each record once, the buffers are not initialized
+    // since every item is written before read
+    std::unique_ptr<item_t[]> items(new item_t[n]), scratch(new item_t[n]);
+    for (std::size_t i = 0; i < n; ++i) {
+        items[i].key = static_cast<key_t>(std::invoke(proj, first[i]));
+        items[i].pos = static_cast<std::uint32_t>(i);
+    }
+    detail::bucket_merge<key_bits / DigitBits, DigitBits, Order>(
+        items.get(), scratch.get(), n, true);
+
+    // Move the records according to the sorted positions
+    std::vector<value_t> records;
+    records.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        records.push_back(std::move(first[items[i].pos]));
+    std::move(records.begin(), records.end(), first);
+}
+
+}  // namespace radsort
+
+#endif  // __RADSORT_HPP__
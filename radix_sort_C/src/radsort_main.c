@@ -24,6 +24,7 @@
 
 // Include header
 #include "radsort.h"
+#include "radsort_perf.h"
 #include <time.h>
 #include <string.h>
 
@@ -37,7 +38,7 @@ int main( int argc, char *argv[])
     uint64_t upper     = 65535; //05000000;
     // uint64_t upper     = (uint64_t) 9999999999999999999; //65535; //05000000;
     uint64_t lower     = 16300;
-    uint64_t unsorted_list[max];
+    uint64_t *unsorted_list;
     uint64_t *sorted_list;
     char s_order = 'a';
 
@@ -59,7 +60,15 @@ int main( int argc, char *argv[])
         printf("No sorting order argument provided. Defaulting to ascending order.\n");
     }
     printf("selected Sorting order: %c\n", s_order);
-    
+    // Optional second argument is the number of random numbers to sort
+    if (argc > 2 && atol(argv[2]) > 0)  max = (uint32_t)atol(argv[2]);
+    printf("Number of random numbers: %u\n", max);
+    unsorted_list = malloc(sizeof(uint64_t) * max);
+    if (unsorted_list == NULL) {
+        printf("Memory allocation failed for unsorted list.\n");
+        return 1;
+    }
+
 
     // Generate unsorted list of random numbers
     srand(time(0));
@@ -76,13 +85,28 @@ int main( int argc, char *argv[])
     print_head_tail_list(unsorted_list, max); puts("");
 
     // Sorting the number list
+    #ifdef PERF_COUNTERS_ENABLED
+    printf("Hardware counters available: %u\n", perf_open());
+    #endif
+    clock_t start = clock();
     sorted_list = recur_radix_sort_hNd(unsorted_list, max, 4, s_order);
     // sorted_list = async_radix_sort_hNd(unsorted_list, max, 4, s_order);
 
+    printf("Sort CPU time: %.3f ms\n", (double)(clock() - start) * 1000 / CLOCKS_PER_SEC);
+    #ifdef PERF_COUNTERS_ENABLED
+    perf_print_report(max);
+    perf_close();
+    #endif
+    if (sorted_list == NULL) {
+        free(unsorted_list);
+        return 1;
+    }
+
     // Print sorted list
     print_head_tail_list(sorted_list, max);
     // printf("Sorted list: %llx\n", sorted_list[0]);
 
     free(sorted_list);
+    free(unsorted_list);
     return 0;
 }
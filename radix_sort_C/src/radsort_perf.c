@@ -0,0 +1,248 @@
+/**
+ * @file radsort_perf.c
+ * @author Md. Sayeed Al Masud (planetmind@outlook.com)
+ * @brief Hardware performance counters of sort phases
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// ======================================================================== //
+// clock_gettime() and syscall() are declared only with it, also in a strict
+// -std=c11 build
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+#include "radsort_perf.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ======================================================================== //
+// Counters and results of phases
+// ======================================================================== //
+// A perf_event_open() counter counts only the thread which opened it (and
+// its child threads after they exit), so each sorting thread opens its own
+// counters at its first phase. The counters of all threads are kept in
+// all_fds, so perf_close() can close them, also of the exited threads.
+#define PERF_MAX_THREADS  64
+static int all_fds[PERF_MAX_THREADS][PERF_N_EVENTS];
+static atomic_uint n_fd_slots = 0;    // Used rows of all_fds
+static atomic_uint perf_gen = 0;      // Changed by each open and close
+static atomic_bool perf_on = 0;       // Counters are used after perf_open()
+// Counters of the calling thread and the generation when they were opened
+static _Thread_local int perf_fds[PERF_N_EVENTS] = { -1, -1, -1, -1, -1 };
+static _Thread_local unsigned fds_gen = 0;
+// Results and the counts and time at the begining of each phase are kept
+// per thread, so the sorts of several threads don't race on them
+static _Thread_local perf_result_t perf_results[PERF_N_PHASES];
+static _Thread_local uint64_t begin_count[PERF_N_PHASES][PERF_N_EVENTS];
+static _Thread_local uint64_t begin_ns[PERF_N_PHASES];
+
+static const char *event_names[PERF_N_EVENTS] = {
+    "cycles", "instr", "LLC-miss", "dTLB-miss", "br-miss"
+};
+static const char *phase_names[PERF_N_PHASES] = {
+    "top radix_pos", "recursion", "gather"
+};
+
+// ======================================================================== //
+// Description of all functions
+// ======================================================================== //
+// ------------------------------------------------------------------------ //
+static uint64_t now_ns( void )
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// Read the current value of a counter, 0 if it is not available
+static uint64_t read_counter( perf_event_t ev )
+{
+    uint64_t value = 0;
+    #ifdef __linux__
+    if (perf_fds[ev] < 0)  return 0;
+    if (read(perf_fds[ev], &value, sizeof(value)) != sizeof(value))  value = 0;
+    #else
+    (void)ev;
+    #endif
+    return value;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// Open the counters of the calling thread and keep them in a row of all_fds.
+// Without a free row the thread has no counters, only the timer.
+static void open_thread_counters( void )
+{
+    for (uint8_t ev = 0; ev < PERF_N_EVENTS; ++ev)  perf_fds[ev] = -1;
+    fds_gen = atomic_load(&perf_gen);
+    #ifdef __linux__
+    unsigned slot = atomic_fetch_add(&n_fd_slots, 1);
+    if (slot >= PERF_MAX_THREADS)  return;
+    // Type and config of each event in order of perf_event_t
+    const uint32_t ev_type[PERF_N_EVENTS] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+        PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE
+    };
+    const uint64_t ev_config[PERF_N_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for (uint8_t ev = 0; ev < PERF_N_EVENTS; ++ev) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = ev_type[ev];
+        attr.config = ev_config[ev];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;  // Count the joined worker threads of async sort
+        perf_fds[ev] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        all_fds[slot][ev] = perf_fds[ev];
+    }
+    #endif
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// Bring the counters of the calling thread up to the last perf_open() or
+// perf_close(), the counters are opened at the first phase after open
+static void sync_thread_counters( void )
+{
+    unsigned gen = atomic_load(&perf_gen);
+    if (fds_gen == gen)  return;
+    if (atomic_load(&perf_on)) {
+        open_thread_counters();
+    } else {
+        for (uint8_t ev = 0; ev < PERF_N_EVENTS; ++ev)  perf_fds[ev] = -1;
+        fds_gen = gen;
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+uint8_t perf_open( void )
+{
+    perf_close();
+    atomic_store(&perf_on, 1);
+    atomic_fetch_add(&perf_gen, 1);
+    open_thread_counters();
+    uint8_t n_open = 0;
+    for (uint8_t ev = 0; ev < PERF_N_EVENTS; ++ev)
+        if (perf_fds[ev] >= 0)  n_open += 1;
+    perf_reset();
+    return n_open;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+void perf_close( void )
+{
+    atomic_store(&perf_on, 0);
+    atomic_fetch_add(&perf_gen, 1);  // Counters of other threads are stale
+    unsigned n_slots = atomic_exchange(&n_fd_slots, 0);
+    if (n_slots > PERF_MAX_THREADS)  n_slots = PERF_MAX_THREADS;
+    for (unsigned slot = 0; slot < n_slots; ++slot) {
+        for (uint8_t ev = 0; ev < PERF_N_EVENTS; ++ev) {
+            #ifdef __linux__
+            if (all_fds[slot][ev] >= 0)  close(all_fds[slot][ev]);
+            #endif
+            all_fds[slot][ev] = -1;
+        }
+    }
+    for (uint8_t ev = 0; ev < PERF_N_EVENTS; ++ev)  perf_fds[ev] = -1;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+void perf_reset( void )
+{
+    memset(perf_results, 0, sizeof(perf_results));
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+void perf_phase_begin( perf_phase_t phase )
+{
+    sync_thread_counters();
+    for (uint8_t ev = 0; ev < PERF_N_EVENTS; ++ev)
+        begin_count[phase][ev] = read_counter(ev);
+    begin_ns[phase] = now_ns();
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+void perf_phase_end( perf_phase_t phase )
+{
+    uint64_t end_ns = now_ns();
+    for (uint8_t ev = 0; ev < PERF_N_EVENTS; ++ev)
+        perf_results[phase].count[ev] +=
+            read_counter(ev) - begin_count[phase][ev];
+    perf_results[phase].time_ns += end_ns - begin_ns[phase];
+    perf_results[phase].n_calls += 1;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+uint8_t perf_get_result( perf_phase_t phase, perf_result_t *result )
+{
+    if (result != NULL)  *result = perf_results[phase];
+    sync_thread_counters();
+    uint8_t valid = 0;
+    for (uint8_t ev = 0; ev < PERF_N_EVENTS; ++ev)
+        if (perf_fds[ev] >= 0)  valid |= (uint8_t)(1u << ev);
+    return valid;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+void perf_print_report( uint32_t n_keys )
+{
+    if (n_keys == 0)  n_keys = 1;
+    puts("= = = = = = = = = = = = = = = = = = = = = = = = = = = = = =");
+    printf("%-14s %10s", "Phase(per key)", "time(ms)");
+    for (uint8_t ev = 0; ev < PERF_N_EVENTS; ++ev)
+        printf(" %10s", event_names[ev]);
+    puts("");
+    for (uint8_t p = 0; p < PERF_N_PHASES; ++p) {
+        perf_result_t res;
+        uint8_t valid = perf_get_result(p, &res);
+        if (res.n_calls == 0)  continue;  // Phase not used by the sort
+        printf("%-14s %10.3f", phase_names[p], res.time_ns / 1e6);
+        for (uint8_t ev = 0; ev < PERF_N_EVENTS; ++ev) {
+            if (valid & (1u << ev))
+                printf(" %10.3f", (double)res.count[ev] / n_keys);
+            else
+                printf(" %10s", "n/a");
+        }
+        puts("");
+    }
+}
+// ------------------------------------------------------------------------ //
@@ -0,0 +1,174 @@
+/**
+ * @file radsort_perf.h
+ * @author Md. Sayeed Al Masud (planetmind@outlook.com)
+ * @brief Hardware performance counters of sort phases
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @details This is an optional instrumentation layer for tuning the sort.
+ * It counts cycles, instructions, LLC misses, dTLB misses and branch misses
+ * by Linux perf_event_open() around each phase of sort (top level
+ * radix_pos, recursion of buckets and gather of sorted list), together with
+ * the wall time of each phase. If a counter is not available (not Linux, no
+ * permission or not supported by CPU/VM) only the wall time is reported.
+ * The phases of library are measured only if PERF_COUNTERS_ENABLED is
+ * defined, otherwise the PERF_BEGIN()/PERF_END() macros are empty.
+ * The counters and results are kept per thread. A counter counts only the
+ * thread which opened it and its child threads after they exit, so after
+ * perf_open() each sorting thread (e.g. a worker of the pool) opens its own
+ * counters at its first phase, and perf_get_result() return the phases of
+ * the calling thread. The joined worker threads of async sort are counted in
+ * the phase of the thread which called the sort. Up to 64 threads get
+ * counters after each perf_open(), the others get only the wall time.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Header guard
+#ifndef __RADSORT_PERF_H__
+#define __RADSORT_PERF_H__
+
+// For C++ compiler compatibility
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ======================================================================== //
+// Include library
+// ======================================================================== //
+#include <stdint.h>
+
+// ======================================================================== //
+// Define macros
+// ======================================================================== //
+// #define PERF_COUNTERS_ENABLED  // Enable counters of sort phases
+
+/**
+ * @brief Begin and end the measurement of a sort phase
+ * @details These macros are used inside the sort functions. They call the
+ * counter functions only if PERF_COUNTERS_ENABLED is defined.
+ * @param p The phase (perf_phase_t)
+ */
+#ifdef PERF_COUNTERS_ENABLED
+#define PERF_BEGIN(p)  perf_phase_begin(p)
+#define PERF_END(p)    perf_phase_end(p)
+#else
+#define PERF_BEGIN(p)  ((void)0)
+#define PERF_END(p)    ((void)0)
+#endif
+
+// ======================================================================== //
+// Structure/Union and Type declaration
+// ======================================================================== //
+/**
+ * @brief The phases of a sort which are measured separately
+ */
+typedef enum {
+    PERF_PHASE_TOP = 0,    // Top level radix_pos()
+    PERF_PHASE_RECUR,      // Recursion of buckets (all workers for async)
+    PERF_PHASE_GATHER,     // Copy numbers into sorted list
+    PERF_N_PHASES
+} perf_phase_t;
+
+/**
+ * @brief The hardware events which are counted
+ */
+typedef enum {
+    PERF_EV_CYCLES = 0,
+    PERF_EV_INSTRUCTIONS,
+    PERF_EV_LLC_MISSES,
+    PERF_EV_DTLB_MISSES,
+    PERF_EV_BRANCH_MISSES,
+    PERF_N_EVENTS
+} perf_event_t;
+
+/**
+ * @brief The accumulated result of a phase
+ */
+typedef struct {
+    uint64_t count[PERF_N_EVENTS];  // Count of each event
+    uint64_t time_ns;               // Wall time in nanoseconds
+    uint32_t n_calls;               // Number of measured begin/end pairs
+} perf_result_t;
+
+// ======================================================================== //
+// Function declaration
+// ======================================================================== //
+/**
+ * @brief The function open the hardware counters of the calling thread,
+ * and let the other threads open their counters at their first phase. It
+ * must not be called while a phase is measured by any thread.
+ *
+ * @return uint8_t The number of available counters, 0 if only timer is used
+ */
+uint8_t perf_open( void );
+
+/**
+ * @brief The function close the opened counters of all threads. It must
+ * not be called while a phase is measured by any thread.
+ * @return void Return nothing
+ */
+void perf_close( void );
+
+/**
+ * @brief The function clear the accumulated results of all phases of the
+ * calling thread.
+ * @return void Return nothing
+ */
+void perf_reset( void );
+
+/**
+ * @brief The function start the measurement of a phase.
+ * @param phase The phase which is started
+ * @return void Return nothing
+ */
+void perf_phase_begin( perf_phase_t phase );
+
+/**
+ * @brief The function stop the measurement of a phase and add the counts
+ * and time into the result of that phase.
+ * @param phase The phase which is stopped
+ * @return void Return nothing
+ */
+void perf_phase_end( perf_phase_t phase );
+
+/**
+ * @brief The function copy the accumulated result of a phase of the calling
+ * thread.
+ *
+ * @param phase The phase of the result
+ * @param result The pointer where the result will be copied
+ * @return uint8_t 1 if the counter of an event is available, as bit mask of
+ * perf_event_t (bit 0 for cycles)
+ */
+uint8_t perf_get_result( perf_phase_t phase, perf_result_t *result );
+
+/**
+ * @brief The function print the result of each phase of the calling thread
+ * as counts per sorted number and wall time. Unavailable counters are
+ * printed as "n/a".
+ *
+ * @param n_keys The number of sorted numbers
+ * @return void Return nothing
+ */
+void perf_print_report( uint32_t n_keys );
+
+
+// Compatibility and header guard
+#ifdef __cplusplus
+}
+#endif
+#endif  // __RADSORT_PERF_H__
@@ -0,0 +1,423 @@
+/**
+ * @file radsort_check.c
+ * @author Md. Sayeed Al Masud (planetmind@outlook.com)
+ * @brief Check the sort functions against qsort()
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @details This program sort random lists of several sizes, digit lengths
+ * and duplicate rates by each public sort function in both orders, and
+ * compare the result with qsort() of the same list. The multi thread
+ * functions (async sort and worker pool) are checked only if
+ * ASYNC_SORT_ENABLED is defined. It print the failed cases and return the
+ * number of failures, so "make test" fails if any check fails.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Include header
+#include "radsort.h"
+#include <string.h>
+#ifdef ASYNC_SORT_ENABLED
+#include <sched.h>
+#include <errno.h>
+#endif
+
+// ======================================================================== //
+// Check helpers
+// ======================================================================== //
+static uint32_t n_checks = 0, n_fails = 0;
+
+// Count a check, print the case if it is failed
+#define CHECK(cond, ...)                                                     \
+    do {                                                                     \
+        n_checks += 1;                                                       \
+        if (!(cond)) {                                                       \
+            n_fails += 1;                                                    \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                      \
+            printf(__VA_ARGS__);                                             \
+            puts("");                                                        \
+        }                                                                    \
+    } while (0)
+
+// Sizes of lists, around the small bucket size and above the thread limits
+static const uint32_t list_sizes[] = { 0, 1, 2, 7, 32, 33, 100, 1000, 70000 };
+#define N_SIZES (sizeof(list_sizes) / sizeof(list_sizes[0]))
+static const char sort_orders[] = { 'a', 'd' };
+
+// ------------------------------------------------------------------------ //
+// Random number generator (xorshift64), same lists for each run
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+static uint64_t rand_u64( void )
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// Make a random list of numbers of digit_h_N hex digits. If few_keys is not
+// zero, only few different numbers are used (many duplicates).
+static uint64_t* make_list( uint32_t l_size, uint8_t digit_h_N,
+        uint8_t few_keys )
+{
+    uint64_t mask = (digit_h_N >= 16) ? ~0ull :
+                    ((1ull << (digit_h_N << 2)) - 1);
+    uint64_t *list = malloc(sizeof(uint64_t) * (l_size ? l_size : 1));
+    if (list == NULL)  return NULL;
+    for (uint32_t i = 0; i < l_size; ++i) {
+        uint64_t num = rand_u64();
+        list[i] = (few_keys ? (num % 5) * 0x0123456789ABCDEFull : num) & mask;
+    }
+    return list;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+static char cmp_order = 'a';
+static int cmp_u64( const void *a, const void *b )
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    int r = (x > y) - (x < y);
+    return (cmp_order == 'd') ? -r : r;
+}
+
+// Make the reference sorted copy of a list by qsort()
+static uint64_t* ref_sort( const uint64_t list[], uint32_t l_size,
+        char sort_order )
+{
+    uint64_t *ref = malloc(sizeof(uint64_t) * (l_size ? l_size : 1));
+    if (ref == NULL)  return NULL;
+    memcpy(ref, list, sizeof(uint64_t) * l_size);
+    cmp_order = sort_order;
+    qsort(ref, l_size, sizeof(uint64_t), cmp_u64);
+    return ref;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+static uint8_t same_list( const uint64_t *a, const uint64_t *b, uint32_t n )
+{
+    return (a != NULL && b != NULL &&
+            memcmp(a, b, sizeof(uint64_t) * n) == 0);
+}
+// ------------------------------------------------------------------------ //
+
+
+// ======================================================================== //
+// Checks of each group of sort functions
+// ======================================================================== //
+// ------------------------------------------------------------------------ //
+static void check_full_sorts( void )
+{
+    for (uint8_t digit_h_N = 1; digit_h_N <= 16; digit_h_N += 3)
+    for (uint32_t z = 1; z < N_SIZES; ++z)
+    for (uint8_t o = 0; o < 2; ++o) {
+        uint32_t l_size = list_sizes[z];
+        char s_order = sort_orders[o];
+        uint64_t *u_list = make_list(l_size, digit_h_N, z & 1);
+        uint64_t *ref = ref_sort(u_list, l_size, s_order);
+        uint64_t *s_list = recur_radix_sort_hNd(u_list, l_size, digit_h_N,
+                                                s_order);
+        CHECK(same_list(s_list, ref, l_size), "recur n=%u d=%u %c",
+              l_size, digit_h_N, s_order);
+        free(s_list);
+        s_list = radix_sort_auto(u_list, l_size, s_order);
+        CHECK(same_list(s_list, ref, l_size), "auto n=%u d=%u %c",
+              l_size, digit_h_N, s_order);
+        free(s_list);
+        #ifdef ASYNC_SORT_ENABLED
+        s_list = async_radix_sort_hNd(u_list, l_size, digit_h_N, s_order);
+        CHECK(same_list(s_list, ref, l_size), "async n=%u d=%u %c",
+              l_size, digit_h_N, s_order);
+        free(s_list);
+        #endif
+        if (digit_h_N <= 8) {
+            // The same numbers as 32-bit keys
+            uint32_t *u32 = malloc(sizeof(uint32_t) * l_size);
+            for (uint32_t i = 0; i < l_size; ++i)  u32[i] = (uint32_t)u_list[i];
+            uint32_t *s32 = recur_radix_sort_hNd_u32(u32, l_size, digit_h_N,
+                                                     s_order);
+            uint8_t same = (s32 != NULL);
+            for (uint32_t i = 0; same && i < l_size; ++i)
+                same = (s32[i] == ref[i]);
+            CHECK(same, "u32 n=%u d=%u %c", l_size, digit_h_N, s_order);
+            free(s32);  free(u32);
+        }
+        free(ref);  free(u_list);
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// Copy a list into narrow keys, and compare narrow keys with a list
+#define DEFINE_NARROW_HELPERS(sfx, key_t)                                    \
+static key_t* narrow_copy##sfx( const uint64_t list[], uint32_t l_size )     \
+{                                                                            \
+    key_t *n_list = malloc(sizeof(key_t) * (l_size ? l_size : 1));           \
+    if (n_list == NULL)  return NULL;                                        \
+    for (uint32_t i = 0; i < l_size; ++i)  n_list[i] = (key_t)list[i];       \
+    return n_list;                                                           \
+}                                                                            \
+static uint8_t same_narrow##sfx( const key_t *a, const uint64_t *b,          \
+        uint32_t n )                                                         \
+{                                                                            \
+    if (a == NULL || b == NULL)  return 0;                                   \
+    for (uint32_t i = 0; i < n; ++i)  if (a[i] != b[i])  return 0;           \
+    return 1;                                                                \
+}
+DEFINE_NARROW_HELPERS(_u8, uint8_t)
+DEFINE_NARROW_HELPERS(_u16, uint16_t)
+DEFINE_NARROW_HELPERS(_u32, uint32_t)
+
+static void check_narrow_sorts( void )
+{
+    for (uint8_t digit_h_N = 1; digit_h_N <= 4; ++digit_h_N)
+    for (uint32_t z = 1; z < N_SIZES; ++z)
+    for (uint8_t o = 0; o < 2; ++o) {
+        uint32_t l_size = list_sizes[z];
+        char s_order = sort_orders[o];
+        uint64_t *u_list = make_list(l_size, digit_h_N, z & 1);
+        uint64_t *ref = ref_sort(u_list, l_size, s_order);
+        radsort_stats_t stats;
+        if (digit_h_N <= 2) {
+            uint8_t *u8 = narrow_copy_u8(u_list, l_size);
+            // The plan of the auto sort must not be left in the stats
+            free(radix_sort_auto(u_list, l_size, s_order));
+            uint8_t *s8 = radix_sort_hNd(u8, l_size, digit_h_N, s_order);
+            radsort_get_stats(&stats);
+            CHECK(same_narrow_u8(s8, ref, l_size), "u8 n=%u d=%u %c",
+                  l_size, digit_h_N, s_order);
+            CHECK(stats.engine == RADSORT_ENGINE_NONE,
+                  "u8 stats n=%u d=%u %c", l_size, digit_h_N, s_order);
+            free(s8);  free(u8);
+        }
+        uint16_t *u16 = narrow_copy_u16(u_list, l_size);
+        free(radix_sort_auto(u_list, l_size, s_order));
+        uint16_t *s16 = radix_sort_hNd(u16, l_size, digit_h_N, s_order);
+        radsort_get_stats(&stats);
+        CHECK(same_narrow_u16(s16, ref, l_size), "u16 n=%u d=%u %c",
+              l_size, digit_h_N, s_order);
+        CHECK(stats.engine == RADSORT_ENGINE_NONE,
+              "u16 stats n=%u d=%u %c", l_size, digit_h_N, s_order);
+        free(s16);  free(u16);
+        // The type-generic macro select the function of each key width
+        uint32_t *u32 = narrow_copy_u32(u_list, l_size);
+        uint32_t *s32 = radix_sort_hNd(u32, l_size, digit_h_N, s_order);
+        CHECK(same_narrow_u32(s32, ref, l_size), "generic u32 n=%u d=%u %c",
+              l_size, digit_h_N, s_order);
+        free(s32);  free(u32);
+        uint64_t *s64 = radix_sort_hNd(u_list, l_size, digit_h_N, s_order);
+        CHECK(same_list(s64, ref, l_size), "generic u64 n=%u d=%u %c",
+              l_size, digit_h_N, s_order);
+        free(s64);  free(ref);  free(u_list);
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+static void check_selection( void )
+{
+    for (uint32_t z = 1; z < N_SIZES; ++z)
+    for (uint8_t o = 0; o < 2; ++o) {
+        uint32_t l_size = list_sizes[z];
+        char s_order = sort_orders[o];
+        uint64_t *u_list = make_list(l_size, 6, z & 1);
+        uint64_t *ref = ref_sort(u_list, l_size, s_order);
+        const uint32_t ks[] = { 1, l_size / 3 + 1, l_size };
+        for (uint8_t n = 0; n < 3; ++n) {
+            uint32_t k = ks[n];
+            uint64_t *top = radix_topk(u_list, l_size, 6, k, s_order);
+            CHECK(same_list(top, ref, k), "topk n=%u k=%u %c",
+                  l_size, k, s_order);
+            free(top);
+            // First k are sorted, the rest are the other numbers
+            uint64_t *part = radix_partial_sort(u_list, l_size, 6, k, s_order);
+            uint8_t same = same_list(part, ref, k);
+            if (same) {
+                cmp_order = s_order;
+                qsort(part + k, l_size - k, sizeof(uint64_t), cmp_u64);
+                same = same_list(part + k, ref + k, l_size - k);
+            }
+            CHECK(same, "partial n=%u k=%u %c", l_size, k, s_order);
+            free(part);
+            const uint64_t *nth = radix_nth_element(u_list, l_size, 6, k - 1,
+                                                    s_order);
+            CHECK(nth != NULL && *nth == ref[k-1], "nth n=%u nth=%u %c",
+                  l_size, k - 1, s_order);
+        }
+        free(ref);  free(u_list);
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+static void check_unique_count( void )
+{
+    for (uint32_t z = 0; z < N_SIZES; ++z)
+    for (uint8_t o = 0; o < 2; ++o) {
+        uint32_t l_size = list_sizes[z];
+        char s_order = sort_orders[o];
+        uint64_t *u_list = make_list(l_size, 4, z & 1);
+        uint64_t *ref = ref_sort(u_list, l_size, s_order);
+        uint32_t *counts = NULL, n_unique = 0;
+        uint64_t *uq = radix_sort_unique_count(u_list, l_size, 4, s_order,
+                                               &counts, &n_unique);
+        // Expand the counts, it must be same as the sorted list
+        uint8_t same = (uq != NULL);
+        uint32_t pos = 0;
+        for (uint32_t u = 0; same && u < n_unique; ++u) {
+            same = (u == 0 || uq[u] != uq[u-1]);
+            for (uint32_t c = 0; same && c < counts[u]; ++c)
+                same = (pos < l_size && ref[pos++] == uq[u]);
+        }
+        CHECK(same && pos == l_size, "unique n=%u %c", l_size, s_order);
+        free(uq);  free(counts);  free(ref);  free(u_list);
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+static void check_segments( void )
+{
+    for (uint8_t o = 0; o < 2; ++o) {
+        char s_order = sort_orders[o];
+        // Segments of all sizes, including empty ones
+        uint32_t n_segs = 2 * N_SIZES;
+        uint32_t seg_offs[2 * N_SIZES + 1];
+        seg_offs[0] = 0;
+        for (uint32_t s = 0; s < n_segs; ++s)
+            seg_offs[s+1] = seg_offs[s] + list_sizes[s % N_SIZES];
+        uint32_t l_size = seg_offs[n_segs];
+        uint64_t *u_list = make_list(l_size, 8, o);
+        uint64_t *s_list = radix_sort_segments(u_list, seg_offs, n_segs, 8,
+                                               s_order, NULL);
+        for (uint32_t s = 0; s < n_segs; ++s) {
+            uint32_t seg_sz = seg_offs[s+1] - seg_offs[s];
+            uint64_t *ref = ref_sort(u_list + seg_offs[s], seg_sz, s_order);
+            CHECK(s_list != NULL && same_list(s_list + seg_offs[s], ref, seg_sz),
+                  "segment %u n=%u %c", s, seg_sz, s_order);
+            free(ref);
+        }
+        free(s_list);  free(u_list);
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+static void check_merge_insert( void )
+{
+    for (uint32_t zs = 0; zs < N_SIZES; ++zs)
+    for (uint32_t zb = 0; zb < N_SIZES; zb += 2)
+    for (uint8_t o = 0; o < 2; ++o)
+    for (uint8_t in_place = 0; in_place < 2; ++in_place) {
+        uint32_t s_size = list_sizes[zs], b_size = list_sizes[zb];
+        char s_order = sort_orders[o];
+        uint64_t *batch = make_list(b_size, 8, zb & 1);
+        uint64_t *old = make_list(s_size, 8, zs & 1);
+        uint64_t *sorted = ref_sort(old, s_size, s_order);
+        // Sorted list with room of batch and the reference of both
+        uint64_t *s_list = malloc(sizeof(uint64_t) * (s_size + b_size + 1));
+        memcpy(s_list, sorted, sizeof(uint64_t) * s_size);
+        uint64_t *all = malloc(sizeof(uint64_t) * (s_size + b_size + 1));
+        memcpy(all, sorted, sizeof(uint64_t) * s_size);
+        memcpy(all + s_size, batch, sizeof(uint64_t) * b_size);
+        uint64_t *ref = ref_sort(all, s_size + b_size, s_order);
+        uint64_t *out = in_place ? NULL :
+                        malloc(sizeof(uint64_t) * (s_size + b_size + 1));
+        uint64_t *m_list = radix_merge_insert(s_list, s_size, batch, b_size,
+                                              8, s_order, out);
+        CHECK(m_list == (in_place ? s_list : out) &&
+              same_list(m_list, ref, s_size + b_size),
+              "merge s=%u b=%u %c in_place=%u", s_size, b_size, s_order,
+              in_place);
+        free(out);  free(ref);  free(all);  free(s_list);
+        free(sorted);  free(old);  free(batch);
+    }
+}
+// ------------------------------------------------------------------------ //
+
+#ifdef ASYNC_SORT_ENABLED
+// ------------------------------------------------------------------------ //
+// Callback of a pool job, mark the job which is done
+static void mark_done( uint64_t *s_list, void *user_data )
+{
+    (void)s_list;
+    *(uint8_t *)user_data = 1;
+}
+
+static void check_pool( void )
+{
+    enum { N_JOBS = 24 };
+    const uint64_t one_num[1] = { 1 };
+    errno = 0;
+    CHECK(radsort_submit(one_num, 1, 4, 'a', NULL, NULL) == NULL &&
+          errno == EINVAL, "submit before pool init");
+    CHECK(sort_pool_init(3, 8) == 3, "pool init");
+    errno = 0;
+    CHECK(radsort_submit(one_num, 1, 17, 'a', NULL, NULL) == NULL &&
+          errno == EINVAL, "submit of 17 digits");
+    uint64_t *u_lists[N_JOBS], *refs[N_JOBS];
+    sort_job_t *jobs[N_JOBS];
+    uint8_t cb_done[N_JOBS] = {0};
+    uint32_t n_accepted = 0;
+    for (uint32_t j = 0; j < N_JOBS; ++j) {
+        uint32_t l_size = list_sizes[1 + j % (N_SIZES - 1)];
+        char s_order = sort_orders[j & 1];
+        u_lists[j] = make_list(l_size, 6, j & 2);
+        refs[j] = ref_sort(u_lists[j], l_size, s_order);
+        // Retry only while the queue is full
+        while ((jobs[j] = radsort_submit(u_lists[j], l_size, 6, s_order,
+                    mark_done, &cb_done[j])) == NULL && errno == EAGAIN)
+            sched_yield();
+        n_accepted += (jobs[j] != NULL);
+    }
+    for (uint32_t j = 0; j < N_JOBS; ++j) {
+        uint32_t l_size = list_sizes[1 + j % (N_SIZES - 1)];
+        uint64_t *s_list = (jobs[j] != NULL) ? radsort_wait(jobs[j]) : NULL;
+        CHECK(same_list(s_list, refs[j], l_size) && cb_done[j],
+              "pool job %u n=%u", j, l_size);
+        free(s_list);  free(refs[j]);  free(u_lists[j]);
+    }
+    CHECK(n_accepted == N_JOBS, "pool accepted %u jobs", n_accepted);
+    sort_pool_destroy();
+    errno = 0;
+    CHECK(radsort_submit(one_num, 1, 4, 'a', NULL, NULL) == NULL &&
+          errno == EINVAL, "submit after pool destroy");
+}
+// ------------------------------------------------------------------------ //
+#endif
+
+
+// ======================================================================== //
+// Main function, run all checks
+// ======================================================================== //
+int main( void )
+{
+    check_full_sorts();
+    check_narrow_sorts();
+    check_selection();
+    check_unique_count();
+    check_segments();
+    check_merge_insert();
+    #ifdef ASYNC_SORT_ENABLED
+    check_pool();
+    #endif
+    printf("[radsort_check] %u checks, %u failed\n", n_checks, n_fails);
+    return n_fails == 0 ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file radsort_check.cpp
+ * @author Md. Sayeed Al Masud (planetmind@outlook.com)
+ * @brief Check the C++ front end radsort.hpp against std::stable_sort()
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @details This program sort random vectors of records by a key member of
+ * each width (8 to 64 bits) with radsort::radix_sort() in both orders and
+ * digit widths of 1, 4 and 8 bits, and compare the result with
+ * std::stable_sort() of the same vector. The records carry their original
+ * position, so the stability is checked too. It print the failed cases and
+ * return non-zero if any check fails, so "make test" fails.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Include header
+#include "radsort.hpp"
+#include <cstdio>
+
+// ======================================================================== //
+// Check helpers
+// ======================================================================== //
+static std::uint32_t n_checks = 0, n_fails = 0;
+
+// Count a check, print the case if it is failed
+#define CHECK(cond, ...)                                                     \
+    do {                                                                     \
+        n_checks += 1;                                                       \
+        if (!(cond)) {                                                       \
+            n_fails += 1;                                                    \
+            std::printf("FAIL %s:%d: ", __func__, __LINE__);                 \
+            std::printf(__VA_ARGS__);                                        \
+            std::puts("");                                                   \
+        }                                                                    \
+    } while (0)
+
+// Sizes of vectors, around the small bucket size and larger
+static const std::uint32_t list_sizes[] = { 0, 1, 2, 7, 32, 33, 100, 1000,
+                                            70000 };
+
+// ------------------------------------------------------------------------ //
+// Random number generator (xorshift64), same vectors for each run
+static std::uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+static std::uint64_t rand_u64()
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+// ------------------------------------------------------------------------ //
+
+/**
+ * @brief A record with a key and its original position in the vector
+ */
+template <class Key>
+struct record_t {
+    Key key;
+    std::uint32_t pos;
+};
+
+// ------------------------------------------------------------------------ //
+// Make a vector of records with random keys. If few_keys is true, only few
+// different keys are used (many duplicates).
+template <class Key>
+static std::vector<record_t<Key>> make_records(std::uint32_t l_size,
+                                               bool few_keys)
+{
+    std::vector<record_t<Key>> records(l_size);
+    for (std::uint32_t i = 0; i < l_size; ++i) {
+        std::uint64_t num = rand_u64();
+        records[i].key = static_cast<Key>(
+            few_keys ? (num % 5) * 0x0123456789ABCDEFull : num);
+        records[i].pos = i;
+    }
+    return records;
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// Same keys and positions, so same order of equal keys too
+template <class Key>
+static bool same_records(const std::vector<record_t<Key>> &a,
+                         const std::vector<record_t<Key>> &b)
+{
+    if (a.size() != b.size())  return false;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        if (a[i].key != b[i].key || a[i].pos != b[i].pos)  return false;
+    return true;
+}
+// ------------------------------------------------------------------------ //
+
+
+// ======================================================================== //
+// Checks of radix_sort()
+// ======================================================================== //
+// ------------------------------------------------------------------------ //
+// Sort by the key member in one order and digit width, for all sizes
+template <class Key, unsigned DigitBits, radsort::order Order>
+static void check_records()
+{
+    constexpr bool asc = (Order == radsort::order::ascending);
+    for (std::uint32_t z = 0; z < std::size(list_sizes); ++z) {
+        std::uint32_t l_size = list_sizes[z];
+        auto records = make_records<Key>(l_size, z & 1);
+        auto ref = records;
+        std::stable_sort(ref.begin(), ref.end(),
+            [](const record_t<Key> &a, const record_t<Key> &b) {
+                return asc ? (a.key < b.key) : (a.key > b.key);
+            });
+        radsort::radix_sort<0, DigitBits, Order>(
+            records.begin(), records.end(), &record_t<Key>::key);
+        CHECK(same_records(records, ref), "key=%zu bits digit=%u bits n=%u %c",
+              sizeof(Key) * 8, DigitBits, l_size, asc ? 'a' : 'd');
+    }
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+template <class Key>
+static void check_key_width()
+{
+    check_records<Key, 1, radsort::order::ascending>();
+    check_records<Key, 1, radsort::order::descending>();
+    check_records<Key, 4, radsort::order::ascending>();
+    check_records<Key, 4, radsort::order::descending>();
+    check_records<Key, 8, radsort::order::ascending>();
+    check_records<Key, 8, radsort::order::descending>();
+}
+// ------------------------------------------------------------------------ //
+
+// ------------------------------------------------------------------------ //
+// The default projection and a lambda projection of a narrower key width
+static void check_projections()
+{
+    std::vector<std::uint32_t> nums(1000);
+    for (auto &num : nums)  num = static_cast<std::uint32_t>(rand_u64());
+    auto ref = nums;
+    std::sort(ref.begin(), ref.end());
+    radsort::radix_sort(nums.begin(), nums.end());
+    CHECK(nums == ref, "identity projection");
+
+    // Sort by the low 16 bits only, in a 16-bit key width
+    auto records = make_records<std::uint64_t>(1000, false);
+    auto rec_ref = records;
+    std::stable_sort(rec_ref.begin(), rec_ref.end(),
+        [](const record_t<std::uint64_t> &a, const record_t<std::uint64_t> &b) {
+            return (a.key & 0xFFFF) > (b.key & 0xFFFF);
+        });
+    radsort::radix_sort<16, 4, radsort::order::descending>(
+        records.begin(), records.end(),
+        [](const record_t<std::uint64_t> &r) { return r.key & 0xFFFF; });
+    CHECK(same_records(records, rec_ref), "lambda projection of 16 bits");
+}
+// ------------------------------------------------------------------------ //
+
+
+// ======================================================================== //
+// Main function, run all checks
+// ======================================================================== //
+int main()
+{
+    check_key_width<std::uint8_t>();
+    check_key_width<std::uint16_t>();
+    check_key_width<std::uint32_t>();
+    check_key_width<std::uint64_t>();
+    check_projections();
+    std::printf("[radsort_check_cpp] %u checks, %u failed\n", n_checks,
+                n_fails);
+    return n_fails == 0 ? 0 : 1;
+}